@@ -2,20 +2,47 @@
 #define ENMOD_ACTOR_CRITIC_SOLVER_H
 
 #include "RLSolver.h"
+#include <vector>
 
 class ActorCriticSolver : public RLSolver {
 public:
-    ActorCriticSolver(const Grid& grid_ref);
+    ActorCriticSolver(const Grid& grid_ref, const std::string& name = "ActorCritic");
     void run() override;
     Cost getEvacuationCost() const override;
+    std::unique_ptr<RLSolver> clone() const override;
+    // Also averages the critic's state values, over the workers that visited each state.
+    double mergeWorkers(const std::vector<const RLSolver*>& workers) override;
     void generateReport(std::ofstream& report_file) const override;
     
     void update(const Position& s, Direction a, double r, const Position& s_next, Direction a_next) override;
     Direction chooseAction(const Position& state) override;
+    void initializeFromCostMap(const std::vector<std::vector<Cost>>& cost_map) override;
+    void chooseActionBatch(int lanes, const int* cells, int* actions) override;
+    void updateBatch(int lanes, const int* cells, const int* actions, const double* rewards,
+                     const int* next_cells, const int* next_actions) override;
+
+    // Probability of taking `action` in `cell` under the current softmax policy.
+    double actionProbability(int cell, int action) const;
+
+protected:
+    void syncWithValueTable() override;
 
 private:
-    // The Critic's state-value table
-    std::map<Position, double> state_value_table;
+    static constexpr double ACTOR_ALPHA = 0.01;           // Actor often needs a smaller learning rate
+    static constexpr double SEED_PREFERENCE_RANGE = 5.0;  // Preference gap between best and worst seeded action
+    // Entropy bonus on every actor step. The rewards span -200 to +1000, so without it a few large
+    // TD errors can lock the softmax into a loop before any episode has found an exit.
+    static constexpr double ENTROPY_WEIGHT = 0.1;
+
+    // The Critic's state-value table, indexed by cell id
+    std::vector<double> state_value_table;
+    // Cumulative softmax probabilities of the actor's preferences (value_table), NUM_ACTIONS per cell.
+    // Kept in step with the preferences so sampling an action is one uniform draw and three compares.
+    std::vector<double> action_cdf;
+
+    void refreshActionCdf(int cell);
+    int sampleAction(int cell);
+    void learn(int cell, int action, double reward, int next_cell);
 };
 
 #endif // ENMOD_ACTOR_CRITIC_SOLVER_H
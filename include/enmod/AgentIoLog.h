@@ -0,0 +1,80 @@
+#ifndef ENMOD_AGENT_IO_LOG_H
+#define ENMOD_AGENT_IO_LOG_H
+
+#include "WireCodec.h"
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// One append-only file for every message of a run, in place of a file per message. The log is an
+// 8-byte file header ("EIOL" | version u8 | 3 pad) followed by WireCodec frames back to back; each
+// frame carries its own length, type, agent id and timestep. Next to it, the index holds one
+// 32-byte entry per frame:
+//
+//   agent id char[16] | timestep i32 | frame type u8 | 3 pad | offset u64
+//
+// Frames and index entries are buffered in memory and written together in blocks, the log first,
+// so an index on disk never points past the end of the log. Not thread-safe.
+class AgentIoLog {
+public:
+    static constexpr const char* LOG_FILE = "agent_io.log";
+    static constexpr const char* INDEX_FILE = "agent_io.idx";
+    static constexpr std::uint8_t VERSION = 1;
+    static constexpr std::size_t FILE_HEADER_BYTES = 8;
+    static constexpr std::size_t INDEX_ENTRY_BYTES = 32;
+
+    // Starts a new log in directory, replacing any earlier one. Throws std::runtime_error if the
+    // files cannot be created.
+    explicit AgentIoLog(const std::string& directory);
+    ~AgentIoLog();
+    AgentIoLog(const AgentIoLog&) = delete;
+    AgentIoLog& operator=(const AgentIoLog&) = delete;
+
+    // Appends one complete WireCodec frame and returns its offset in the log.
+    std::uint64_t append(const std::uint8_t* frame, std::size_t length);
+    // Copies the frame at offset into frame; false if there is no complete frame there.
+    bool read(std::uint64_t offset, std::vector<std::uint8_t>& frame);
+    void flush();
+
+private:
+    static constexpr std::size_t FLUSH_BYTES = 1 << 20;
+
+    std::fstream log;
+    std::ofstream index;
+    std::vector<std::uint8_t> pending;       // Frames not yet written
+    std::vector<std::uint8_t> pending_index; // Their index entries
+    std::uint64_t pending_offset = FILE_HEADER_BYTES; // Log offset of pending[0]
+};
+
+// Looks messages of a finished (or still running) log up by agent and timestep. Frames past the
+// last index entry, left by a run that stopped between writing the log and its index, are found
+// by scanning the tail of the log. If an agent sent several messages of one kind in a timestep,
+// the last one is returned.
+class AgentIoLogReader {
+public:
+    // Throws std::runtime_error if directory holds no readable log.
+    explicit AgentIoLogReader(const std::string& directory);
+
+    bool readObservation(const std::string& agent_id, int timestep, AgentObservation& observation);
+    bool readCommand(const std::string& agent_id, int timestep, AgentCommand& command);
+
+    std::size_t getNumMessages() const { return num_messages; }
+    // Timesteps with at least one message from or to the agent, in order.
+    std::vector<int> getTimesteps(const std::string& agent_id) const;
+
+private:
+    using Key = std::tuple<std::string, int, std::uint8_t>; // Agent id, timestep, frame type
+
+    std::ifstream log;
+    std::map<Key, std::uint64_t> offsets;
+    std::size_t num_messages = 0;
+    std::vector<std::uint8_t> frame;
+
+    bool readFrame(std::uint64_t offset);
+    const std::uint64_t* find(const std::string& agent_id, int timestep, WireFrameType type) const;
+};
+
+#endif // ENMOD_AGENT_IO_LOG_H
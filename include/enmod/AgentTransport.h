@@ -0,0 +1,104 @@
+#ifndef ENMOD_AGENT_TRANSPORT_H
+#define ENMOD_AGENT_TRANSPORT_H
+
+#include "EnvironmentDelta.h"
+#include "SpscQueue.h"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+class AgentIoLog;
+
+// Where a FileTransport puts its messages; see FileTransport.
+enum class FileLayout { SHARED, PER_MESSAGE, LOG };
+
+// Agent -> server: where the agent stands and what changed in the environment it observes.
+struct AgentObservation {
+    std::string agent_id;
+    int timestep = 0;
+    Position position = {-1, -1};
+    EnvironmentUpdate environment;
+};
+
+// Server -> agent: the move the agent should make next.
+struct AgentCommand {
+    std::string agent_id;
+    int timestep = 0;
+    Direction move = Direction::STAY;
+    bool resync = false; // The server could not apply the last update and needs a snapshot
+};
+
+// The link between the agents and the decision server. Observations travel up, commands travel
+// down; each direction has one sender and one receiver. send* returns false if the message could
+// not be delivered, receive* returns false if nothing is waiting.
+class AgentTransport {
+public:
+    virtual ~AgentTransport() = default;
+
+    virtual bool sendObservation(AgentObservation observation) = 0;
+    virtual bool receiveObservation(AgentObservation& observation) = 0;
+    virtual bool sendCommand(AgentCommand command) = 0;
+    virtual bool receiveCommand(AgentCommand& command) = 0;
+
+    virtual std::string getName() const = 0;
+
+    // ENMOD_AGENT_TRANSPORT=file selects a FileTransport writing to the given directory in the
+    // given layout, =wire the binary WireTransport; anything else, including no setting, the
+    // in-process channel. ENMOD_AGENT_FILES=shared, per-message or log overrides the layout.
+    static std::unique_ptr<AgentTransport> fromEnvironment(const std::string& directory = ".", FileLayout layout = FileLayout::SHARED);
+};
+
+// Default transport: two single-producer/single-consumer rings in memory. Messages are moved
+// through the rings, so nothing is serialized or copied on the way.
+class InProcessTransport : public AgentTransport {
+public:
+    explicit InProcessTransport(std::size_t capacity = 64);
+
+    bool sendObservation(AgentObservation observation) override;
+    bool receiveObservation(AgentObservation& observation) override;
+    bool sendCommand(AgentCommand command) override;
+    bool receiveCommand(AgentCommand& command) override;
+    std::string getName() const override { return "in-process"; }
+
+private:
+    SpscQueue<AgentObservation> uplink;
+    SpscQueue<AgentCommand> downlink;
+};
+
+// Debugging transport: every message is written to disk and read back, so a run can be inspected
+// or replayed afterwards. SHARED dumps each message as JSON into one reused file per direction
+// (agent_input.json and agent_output.json); PER_MESSAGE keeps every message in its own
+// <agent>_input_t<timestep>.json / <agent>_output_t<timestep>.json, two files per agent and
+// timestep; LOG appends every message as a binary frame to one AgentIoLog, which
+// AgentIoLogReader looks up by agent and timestep.
+class FileTransport : public AgentTransport {
+public:
+    explicit FileTransport(const std::string& directory = ".", FileLayout layout = FileLayout::SHARED);
+    ~FileTransport() override;
+
+    bool sendObservation(AgentObservation observation) override;
+    bool receiveObservation(AgentObservation& observation) override;
+    bool sendCommand(AgentCommand command) override;
+    bool receiveCommand(AgentCommand& command) override;
+    std::string getName() const override { return "file"; }
+
+private:
+    std::string directory;
+    FileLayout layout;
+    // Files written but not yet read. With a single shared file an unread message is overwritten
+    // by the next one, which the receiver notices as a gap in the sequence numbers.
+    std::deque<std::string> pending_inputs;
+    std::deque<std::string> pending_outputs;
+    // LOG: the log and the offsets of the frames written but not yet read
+    std::unique_ptr<AgentIoLog> log;
+    std::deque<std::uint64_t> pending_input_frames;
+    std::deque<std::uint64_t> pending_output_frames;
+    std::vector<std::uint8_t> frame;
+
+    std::string messagePath(const std::string& agent_id, int timestep, const std::string& direction) const;
+    void queue(std::deque<std::string>& pending, const std::string& path) const;
+};
+
+#endif // ENMOD_AGENT_TRANSPORT_H
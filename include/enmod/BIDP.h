@@ -7,6 +7,8 @@
 class BIDP : public Solver {
 public:
     BIDP(const Grid& grid_ref);
+    // Plans towards the given exits only, e.g. one field per exit for assigning agents to doors.
+    BIDP(const Grid& grid_ref, std::vector<Position> target_exits);
     void run() override;
     Cost getEvacuationCost() const override;
     void generateReport(std::ofstream& report_file) const override;
@@ -16,6 +18,7 @@ public:
 
 private:
     std::vector<std::vector<Cost>> cost_map;
+    std::vector<Position> target_exits; // Empty: every exit of the grid
 };
 
 #endif // ENMOD_BIDP_H
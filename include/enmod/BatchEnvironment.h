@@ -0,0 +1,41 @@
+#ifndef ENMOD_BATCH_ENVIRONMENT_H
+#define ENMOD_BATCH_ENVIRONMENT_H
+
+#include "Grid.h"
+#include "QTable.h"
+#include <vector>
+
+// Tabulated RL model of a grid: for every (cell, action) the successor cell and reward are
+// precomputed once, so stepping an episode is two array lookups instead of a chain of
+// Grid queries. step() advances many episodes at once over structure-of-arrays state and
+// has no data-dependent branches, which lets the compiler vectorize it.
+class BatchEnvironment {
+public:
+    explicit BatchEnvironment(const Grid& grid);
+
+    // Reward for moving from current towards next on the given grid. next is reset to current
+    // when the move is blocked. This is the reward model shared by all RL solvers.
+    static double transitionReward(const Grid& grid, const Position& current, Position& next);
+
+    int numCells() const { return static_cast<int>(terminal.size()); }
+    int getCols() const { return cols; }
+    int cellIndex(const Position& pos) const { return pos.row * cols + pos.col; }
+    Position cellPosition(int cell) const { return {cell / cols, cell % cols}; }
+    int startCell() const { return start_cell; }
+
+    int nextCell(int cell, int action) const { return next_cells[cell * NUM_ACTIONS + action]; }
+    double reward(int cell, int action) const { return rewards[cell * NUM_ACTIONS + action]; }
+    bool isTerminal(int cell) const { return terminal[cell] != 0; }
+
+    // Advances `lanes` independent episodes by one step.
+    void step(int lanes, const int* cells, const int* actions, int* out_cells, double* out_rewards, unsigned char* out_done) const;
+
+private:
+    int cols;
+    int start_cell;
+    std::vector<int> next_cells;
+    std::vector<double> rewards;
+    std::vector<unsigned char> terminal;
+};
+
+#endif // ENMOD_BATCH_ENVIRONMENT_H
@@ -0,0 +1,99 @@
+#ifndef ENMOD_BENCHMARK_H
+#define ENMOD_BENCHMARK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Summary statistics of one series of measurements. Percentiles interpolate linearly between
+// the two nearest ranks, so p95/p99 of a short series stay between its observed values.
+struct SampleStats {
+    int count = 0;
+    double mean = 0.0;
+    double stddev = 0.0; // Sample standard deviation (n - 1)
+    double min = 0.0;
+    double median = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+
+    static SampleStats of(std::vector<double> samples);
+};
+
+struct BenchmarkOptions {
+    std::vector<std::string> solvers;              // Empty: every solver known to the SolverFactory
+    std::vector<int> grid_sizes = {5, 10, 20, 50};
+    int warmup = 1;                                // Untimed runs before the measured ones
+    int repetitions = 10;
+    std::uint64_t seed = 0x5EED;                   // Grid layouts and RL seeds derive from this
+    // A solver whose median runtime at one size exceeds this is skipped at the larger sizes, so a
+    // sweep up to 2000x2000 does not stall on the O(n^2)-per-sweep planners.
+    double time_budget_ms = 10000.0;
+    // Lambda of the eligibility traces the Q-learning and SARSA solvers train with; 0 for one-step TD.
+    double trace_decay = 0.0;
+    // Lock-step lanes RL solvers train one-step episodes in; 0 trains them one after another.
+    int batch_lanes = 0;
+    // Threads each RL solver's training is spread over through a ParallelTrainer; 1 trains on one thread.
+    int train_workers = 1;
+};
+
+// One (solver, grid size) cell of a sweep. Cost statistics cover successful runs only.
+struct BenchmarkRecord {
+    std::string solver;
+    int grid_size = 0;
+    int repetitions = 0;
+    int failures = 0;
+    SampleStats runtime_ms;
+    SampleStats weighted_cost;
+};
+
+// Repeated, warmed-up timing of solver->run() over a sweep of generated grids. Runs are strictly
+// sequential so one measurement never competes with another for cores or cache.
+class BenchmarkRunner {
+public:
+    explicit BenchmarkRunner(const BenchmarkOptions& options);
+
+    std::vector<BenchmarkRecord> run();
+
+    static void writeCsv(const std::vector<BenchmarkRecord>& records, const std::string& path);
+    static void writeJson(const std::vector<BenchmarkRecord>& records, const BenchmarkOptions& options, const std::string& path);
+
+private:
+    BenchmarkOptions options;
+};
+
+struct AgentScalingOptions {
+    std::vector<int> agent_counts = {10, 100, 1000, 10000};
+    int grid_size = 150;         // Large enough to seat the biggest crowd
+    int timesteps = 20;          // Measured steps per crowd size, fewer if everyone is out sooner
+    int workers = 0;             // Planning threads; 0 for one per hardware thread
+    std::uint64_t seed = 0x5EED; // Grid layout
+};
+
+// One crowd size of a scaling sweep. Throughput counts one decision per agent still inside per step.
+struct AgentScalingRecord {
+    int agents = 0; // Agents actually placed
+    int workers = 0;
+    int timesteps = 0;
+    long long decisions = 0;
+    double decision_ms = 0.0;
+    double exchange_ms = 0.0;
+    double decisions_per_second = 0.0; // Planning and conflict resolution only
+    double end_to_end_per_second = 0.0; // Including the agent transport
+};
+
+// Decisions per second of MultiAgentCPSController as the crowd grows, on one generated building.
+class AgentScalingBenchmark {
+public:
+    explicit AgentScalingBenchmark(const AgentScalingOptions& options) : options(options) {}
+
+    // Controllers write their scratch reports under work_dir.
+    std::vector<AgentScalingRecord> run(const std::string& work_dir);
+
+    static void writeCsv(const std::vector<AgentScalingRecord>& records, const std::string& path);
+
+private:
+    AgentScalingOptions options;
+};
+
+#endif // ENMOD_BENCHMARK_H
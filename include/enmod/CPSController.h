@@ -3,22 +3,25 @@
 
 #include "Grid.h"
 #include "HybridDPRLSolver.h"
+#include "AgentTransport.h"
+#include "PlanningSession.h"
 #include <string>
 #include <memory>
 
 class CPSController {
 public:
-    CPSController(const json& initial_config);
+    // Without a transport, the one named by ENMOD_AGENT_TRANSPORT (in-process by default) is used.
+    CPSController(const json& initial_config, std::unique_ptr<AgentTransport> transport = nullptr);
     void run_simulation();
 
 private:
     Grid master_grid;
     Position agent_position;
+    EnvironmentDeltaEncoder environment_feed; // Agent side: hazards not yet reported to the server
     std::unique_ptr<HybridDPRLSolver> solver;
+    PlanningSession session;                  // Server side: grid, cost fields and RL policy, kept across timesteps
+    std::unique_ptr<AgentTransport> transport;
     std::string agent_id = "agent_01";
-
-    void write_input_file(int timestep);
-    Direction read_output_file();
 };
 
-#endif // ENMOD_CPS_CONTROLLER_H
\ No newline at end of file
+#endif // ENMOD_CPS_CONTROLLER_H
@@ -0,0 +1,92 @@
+#ifndef ENMOD_COOPERATIVE_PLANNER_H
+#define ENMOD_COOPERATIVE_PLANNER_H
+
+#include "Grid.h"
+#include "SpaceTimeReservations.h"
+#include <vector>
+
+// Windowed hierarchical cooperative A* (WHCA*) for a crowd sharing one grid. Agents plan one at a
+// time, in priority order, through space-time over the next `window` timesteps, avoiding every
+// (cell, timestep) and every swap already reserved by the agents before them, and then reserve
+// their own path. Past the window the agent's BIDP field, which ignores other agents, serves as
+// an exact heuristic: an agent whose steepest-descent path is free for the whole window already
+// has an optimal plan and skips the search, and an obstructed one expands little more than the
+// window itself. A round is planned every timestep and only its first step is carried out.
+//
+// Search nodes, the heap and the visited table are pooled in the planner and reused by every
+// search; nothing is allocated once they have grown to the busiest search so far. A search never
+// strays more than `window` cells from its start, so the visited table is a dense box around it
+// indexed by offset and timestep rather than a hash.
+class CooperativePlanner {
+public:
+    // window is capped at SpaceTimeReservations::MAX_WINDOW.
+    explicit CooperativePlanner(int window = 8, int node_budget = 512);
+
+    // Starts a round for agents 0..n-1 standing on positions[i]. Until an agent has planned, no
+    // other agent may step onto its cell in the first timestep. The grid must outlive the round;
+    // grid_version must change whenever the grid does, as cell costs are cached between rounds.
+    void beginRound(const Grid& grid, std::uint64_t grid_version, const std::vector<Position>& positions);
+
+    // Plans the agent's window on field, comparing Costs under Cost::current_mode, reserves it and
+    // returns its first move. Waiting in a cell costs its smoke and time but no distance.
+    Direction plan(int agent, const std::vector<std::vector<Cost>>& field);
+    // Takes a move chosen elsewhere (the RL policy) if its first step is free, otherwise STAY.
+    Direction claim(int agent, Direction move);
+    // Keeps the agent where it is for the whole window.
+    void hold(int agent);
+
+    int getWindow() const { return window; }
+    long long getExpansions() const { return expansions; }
+
+private:
+    struct Node {
+        Position pos;
+        int dt;
+        int parent;
+        Cost g;
+        Cost f;
+    };
+    // An open node with its f flattened in the order the current mode compares Costs, so the heap
+    // compares plain integers without touching the node.
+    struct OpenEntry {
+        int key[3];
+        int dt;
+        int node;
+    };
+    struct Visited {
+        std::uint32_t search = 0;
+        int node = -1;
+    };
+
+    int window;
+    int node_budget;
+    const Grid* grid = nullptr;
+    std::uint64_t cached_version = 0;
+    std::vector<Cost> move_costs; // Grid::getMoveCost of every cell, flattened
+    std::vector<Position> positions;
+    std::vector<char> planned;
+    SpaceTimeReservations reservations;
+    long long expansions = 0;
+
+    std::vector<Node> nodes;
+    std::vector<OpenEntry> open;
+    std::vector<Visited> visited; // (2 * window + 1)^2 cells around the start for each timestep
+    std::uint32_t search = 0;
+    Position origin;
+    std::vector<int> path;
+
+    int cellOf(const Position& pos) const { return pos.row * grid->getCols() + pos.col; }
+    const Cost& moveCost(const Position& pos) const { return move_costs[cellOf(pos)]; }
+    bool canEnter(int agent, const Position& from, const Position& to, int dt) const;
+    bool followField(int agent, const std::vector<std::vector<Cost>>& field);
+    void reservePath(int agent, int last_node);
+    int& visitedNode(const Position& pos, int dt) {
+        int span = 2 * window + 1;
+        Visited& slot = visited[(dt * span + pos.row - origin.row + window) * span + pos.col - origin.col + window];
+        if (slot.search != search) slot = {search, -1};
+        return slot.node;
+    }
+    static Direction directionTo(const Position& from, const Position& to);
+};
+
+#endif // ENMOD_COOPERATIVE_PLANNER_H
@@ -12,7 +12,8 @@
         int time = MAX_COST;
         int distance = MAX_COST;
     
-        inline static EvacuationMode current_mode = EvacuationMode::NORMAL;
+        // Per thread, so solvers running concurrently each compare costs under their own mode.
+        inline static thread_local EvacuationMode current_mode = EvacuationMode::NORMAL;
     
         bool operator<(const Cost& other) const;
         bool operator>(const Cost& other) const;
@@ -22,6 +23,9 @@
     
     std::ostream& operator<<(std::ostream& os, const Cost& cost);
     
+    // Single scalar used to rank solvers in reports: smoke * 1000 + time * 10 + distance, or infinity when unreachable.
+    double weightedCost(const Cost& cost);
+    
     #endif // ENMOD_COST_H
     
 
@@ -10,6 +10,7 @@ public:
     void run() override;
     Cost getEvacuationCost() const override;
     void generateReport(std::ofstream& report_file) const override;
+    bool writeReplay(const std::string& path, std::uint64_t seed) const override;
 
 private:
     std::vector<StepReport> history;
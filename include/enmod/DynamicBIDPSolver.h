@@ -1,7 +1,8 @@
 #ifndef ENMOD_DYNAMIC_BIDP_SOLVER_H
 #define ENMOD_DYNAMIC_BIDP_SOLVER_H
 
-#include "DynamicSolver.h"
+#include "DynamicSimulation.h"
+#include "StepPolicies.h"
 #include "Types.h"
 
 class DynamicBIDPSolver : public Solver {
@@ -10,13 +11,13 @@ public:
     void run() override;
     Cost getEvacuationCost() const override;
     void generateReport(std::ofstream& report_file) const override;
+    bool writeReplay(const std::string& path, std::uint64_t seed) const override;
 
 private:
     std::vector<StepReport> history;
     Cost total_cost;
-    EvacuationMode current_mode;
-    void assessThreatAndSetMode(const Position& current_pos, const Grid& current_grid);
+    DynamicSimulation simulation;
+    BIDPStepPolicy step_policy;
 };
 
 #endif // ENMOD_DYNAMIC_BIDP_SOLVER_H
-
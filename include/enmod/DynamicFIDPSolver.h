@@ -1,8 +1,9 @@
 #ifndef ENMOD_DYNAMIC_FIDP_SOLVER_H
 #define ENMOD_DYNAMIC_FIDP_SOLVER_H
 
-#include "DynamicSolver.h"
-#include "Types.h" // <-- The critical fix is adding this line
+#include "DynamicSimulation.h"
+#include "StepPolicies.h"
+#include "Types.h"
 
 class DynamicFIDPSolver : public Solver {
 public:
@@ -10,13 +11,13 @@ public:
     void run() override;
     Cost getEvacuationCost() const override;
     void generateReport(std::ofstream& report_file) const override;
+    bool writeReplay(const std::string& path, std::uint64_t seed) const override;
 
 private:
     std::vector<StepReport> history;
     Cost total_cost;
-    EvacuationMode current_mode;
-    void assessThreatAndSetMode(const Position& current_pos, const Grid& current_grid);
+    DynamicSimulation simulation;
+    FIDPStepPolicy step_policy;
 };
 
 #endif // ENMOD_DYNAMIC_FIDP_SOLVER_H
-
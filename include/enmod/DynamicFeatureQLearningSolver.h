@@ -0,0 +1,32 @@
+#ifndef ENMOD_DYNAMIC_FEATURE_Q_LEARNING_SOLVER_H
+#define ENMOD_DYNAMIC_FEATURE_Q_LEARNING_SOLVER_H
+
+#include "DynamicSimulation.h"
+#include "FeatureQModel.h"
+#include "StepPolicies.h"
+#include "Types.h"
+
+// Evacuates through the hazard timeline with one feature-based model. The weights are fitted once
+// on the initial grid, or handed over from a model trained elsewhere, and every later grid state
+// is evaluated with them as is, where DynamicQLearningSim keeps relearning its table.
+class DynamicFeatureQLearningSolver : public Solver {
+public:
+    DynamicFeatureQLearningSolver(const Grid& grid_ref);
+    void run() override;
+    Cost getEvacuationCost() const override;
+    void generateReport(std::ofstream& report_file) const override;
+    bool writeReplay(const std::string& path, std::uint64_t seed) const override;
+
+    // Supplies pre-trained weights; run() then skips the fit on the initial grid.
+    void setModel(const LinearQModel& trained_model) { model = trained_model; pretrained = true; }
+
+private:
+    std::vector<StepReport> history;
+    Cost total_cost;
+    LinearQModel model;
+    bool pretrained = false;
+    DynamicSimulation simulation;
+    FeatureQStepPolicy step_policy;
+};
+
+#endif // ENMOD_DYNAMIC_FEATURE_Q_LEARNING_SOLVER_H
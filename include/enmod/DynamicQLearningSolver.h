@@ -10,8 +10,11 @@ public:
     void run() override;
     Cost getEvacuationCost() const override;
     void generateReport(std::ofstream& report_file) const override;
+    bool writeReplay(const std::string& path, std::uint64_t seed) const override;
 
 private:
+    static constexpr int OFFLINE_EPISODES = 250;
+
     std::vector<StepReport> history;
     Cost total_cost;
 };
@@ -0,0 +1,59 @@
+#ifndef ENMOD_DYNAMIC_SIMULATION_H
+#define ENMOD_DYNAMIC_SIMULATION_H
+
+#include "DynamicSolver.h"
+#include "Types.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// What a step policy wants the agent to do at one time step.
+struct StepDecision {
+    Position next_pos;
+    std::string action;
+    bool no_path = false; // Ends the run as "FAILURE: No path found."
+};
+
+// Per-step decision rule of a dynamic solver. The simulation owns everything else: the hazard
+// timeline, the evolving grid, threat assessment, cost accounting and the history.
+class StepPolicy {
+public:
+    virtual ~StepPolicy() = default;
+    // Called once before every run so policies that carry state between steps start clean.
+    virtual void reset() {}
+    virtual StepDecision decide(const Grid& current_grid, const Position& current_pos, EvacuationMode mode, int time_step) = 0;
+};
+
+// Evacuation mode for an agent at current_pos: PANIC next to an active fire, ALERT within the
+// fire's radius or next to heavy smoke, NORMAL otherwise.
+EvacuationMode assessThreat(const Position& current_pos, const Grid& current_grid);
+
+// Step-by-step evacuation on a grid whose hazards evolve according to its "dynamic_events".
+class DynamicSimulation {
+public:
+    explicit DynamicSimulation(const Grid& initial_grid);
+
+    // Runs one evacuation with the given policy, replacing the contents of history.
+    // Returns the accumulated cost, or the default (unreachable) Cost on failure or timeout.
+    Cost run(StepPolicy& policy, std::vector<StepReport>& history) const;
+
+private:
+    const Grid& initial_grid;
+    std::vector<std::pair<int, const json*>> timeline; // (time step, event), ordered by time step
+    int max_steps;
+};
+
+// Writes a turn-by-turn history in the format shared by all dynamic solver reports.
+void writeSimulationHistory(std::ofstream& report_file, const std::string& title, const std::vector<StepReport>& history);
+
+// Records a single-agent history as a ReplayLog at path, with the hazards of initial_grid's
+// timeline. Returns false, after logging why, if there is nothing to record or the log cannot be
+// written.
+bool writeSimulationReplay(const std::string& path, const Grid& initial_grid, const std::vector<StepReport>& history, std::uint64_t seed);
+
+// "UP", "DOWN", "LEFT" or "RIGHT" followed by the given suffix, or a plain "STAY" for no move.
+std::string actionName(Direction dir, const std::string& suffix = "");
+
+#endif // ENMOD_DYNAMIC_SIMULATION_H
@@ -0,0 +1,38 @@
+#ifndef ENMOD_ELIGIBILITY_TRACES_H
+#define ENMOD_ELIGIBILITY_TRACES_H
+
+#include "QTable.h"
+#include <vector>
+
+// Sparse set of replacing eligibility traces over (cell * NUM_ACTIONS + action) keys.
+// Only the recently visited pairs are stored: traces that decay below `cutoff` are dropped and the
+// set never grows past `capacity` (the weakest trace is evicted), so a TD(lambda) sweep costs
+// O(active traces) instead of O(table size). A dense key -> slot index makes visits O(1).
+class EligibilityTraces {
+public:
+    EligibilityTraces() = default;
+    EligibilityTraces(int num_keys, int capacity = 256, double cutoff = 1e-3);
+
+    void clear();
+    // Replacing trace: e(cell, action) = 1 and the traces of the cell's other actions are cleared,
+    // so actions that were tried and abandoned in a state do not share the credit.
+    void visit(int cell, int action);
+    // Multiplies every trace by factor and drops the ones that fall below the cutoff.
+    void decay(double factor);
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    int key(int i) const { return keys[i]; }
+    double value(int i) const { return values[i]; }
+
+private:
+    std::vector<int> slot_of; // -1 when the key has no trace
+    std::vector<int> keys;
+    std::vector<double> values;
+    int count = 0;
+    double cutoff = 1e-3;
+
+    void remove(int slot);
+};
+
+#endif // ENMOD_ELIGIBILITY_TRACES_H
@@ -0,0 +1,85 @@
+#ifndef ENMOD_ENVIRONMENT_DELTA_H
+#define ENMOD_ENVIRONMENT_DELTA_H
+
+#include "Grid.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// One hazard that appeared since the previous update. The controllers only ever report fires;
+// BLOCKED is part of the message format for agents that observe impassable cells themselves.
+struct EnvironmentChange {
+    enum class Kind { FIRE, BLOCKED };
+    Kind kind = Kind::FIRE;
+    Position pos = {-1, -1};
+    std::string size = "small"; // Fire size, as in a dynamic_events entry; unused for BLOCKED
+};
+
+// What the agent tells the server about its environment in one message: either a full snapshot
+// (scenario config plus every hazard so far) or just the changes since the previous update.
+// Sequence numbers run 1, 2, 3, ... per sender, so the receiver notices a lost update.
+struct EnvironmentUpdate {
+    std::uint64_t sequence = 0;
+    bool is_snapshot = false;
+    std::shared_ptr<const json> snapshot;   // Scenario config; only set when is_snapshot
+    std::vector<EnvironmentChange> changes; // For a snapshot: every hazard applied to the config so far
+
+    json toJson() const;
+    static EnvironmentUpdate fromJson(const json& data);
+};
+
+// Sender side. The first update is a snapshot; after that, the hazards recorded since the last
+// update. requestSnapshot() makes the next one a snapshot again, e.g. after the receiver lost one.
+class EnvironmentDeltaEncoder {
+public:
+    explicit EnvironmentDeltaEncoder(const json& config);
+    // Encoders of agents in one scenario can share its config instead of each holding a copy.
+    explicit EnvironmentDeltaEncoder(std::shared_ptr<const json> config);
+
+    void recordFire(const json& event_config);
+    void requestSnapshot() { snapshot_due = true; }
+
+    EnvironmentUpdate next();
+
+private:
+    std::shared_ptr<const json> config;
+    std::vector<EnvironmentChange> history; // Every change so far, for snapshots
+    std::size_t sent = 0;                   // history[0, sent) has already gone out
+    std::uint64_t sequence = 0;
+    bool snapshot_due = true;
+};
+
+// Receiver side: a Grid kept in step with the senders by applying their updates in place, so the
+// cost of an update is proportional to what changed rather than to the size of the map. Several
+// senders may observe the same environment (the agents of one scenario): each stream's sequence
+// is checked on its own, and a hazard reported by more than one of them is applied once. The
+// first snapshot (or reset) builds the grid; later snapshots only contribute hazards not seen
+// yet, so references to the grid stay valid until the next reset.
+class EnvironmentMirror {
+public:
+    // Returns false, leaving the mirror untouched, when the update does not directly follow the
+    // sender's last one (or the sender has not sent a snapshot yet); it should then send one.
+    bool apply(const EnvironmentUpdate& update, const std::string& sender = "");
+    // Starts from a grid the receiver already has, as if it had arrived as snapshot 0 of sender "".
+    void reset(const Grid& initial_grid);
+
+    bool isReady() const { return grid != nullptr; }
+    const Grid& getGrid() const { return *grid; }
+    std::uint64_t getSequence(const std::string& sender = "") const;
+    // Advances whenever the grid changes, so dependants can tell whether their view is stale.
+    std::uint64_t getVersion() const { return version; }
+
+private:
+    std::unique_ptr<Grid> grid;
+    std::map<std::string, std::uint64_t> sequences;
+    std::set<std::tuple<int, int, int, std::string>> applied; // (kind, row, col, size)
+    std::uint64_t version = 0;
+
+    void applyChange(const EnvironmentChange& change);
+};
+
+#endif // ENMOD_ENVIRONMENT_DELTA_H
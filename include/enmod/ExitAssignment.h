@@ -0,0 +1,41 @@
+#ifndef ENMOD_EXIT_ASSIGNMENT_H
+#define ENMOD_EXIT_ASSIGNMENT_H
+
+#include "Grid.h"
+#include <vector>
+
+// Spreads a crowd over the exits of a building by door capacity instead of sending everyone to
+// the nearest one. Each exit lets `capacity` agents out per timestep ("capacity" in the exit's
+// config entry; by default the number of cells from which it can be stepped onto, which is what
+// the grid lets through), which makes the exits the bottleneck of a time-expanded network:
+// agents are booked, nearest first, into the free (exit, timestep) slot that gets them out
+// soonest, counting both the walk and the wait at the door. A union-find over each exit's slots
+// finds the next free one in near-constant time, so a crowd of thousands is re-solved every
+// timestep in O(agents log agents + agents * exits).
+class ExitAssignment {
+public:
+    explicit ExitAssignment(const Grid& grid);
+
+    // distances[a * getNumExits() + e] is agent a's walk to exit e in steps, MAX_COST if it has no
+    // way there. On entry exits[a] holds the agent's previous exit (or -1); an agent only moves to
+    // another exit if that gets it out more than switch_margin timesteps sooner, so assignments do
+    // not flicker between equally good doors. On return exits[a] is the chosen exit, -1 if none.
+    void solve(const std::vector<int>& distances, std::vector<int>& exits, int switch_margin = 2);
+
+    int getNumExits() const { return static_cast<int>(capacities.size()); }
+    // Timestep at which the last booked agent gets out, by the plan of the last solve().
+    int getClearanceTime() const { return clearance_time; }
+
+private:
+    std::vector<int> capacities;
+    int clearance_time = 0;
+
+    // Reused across solves
+    std::vector<std::pair<int, int>> order;   // (nearest exit distance, agent)
+    std::vector<std::vector<int>> booked;     // Per exit, agents booked into each timestep
+    std::vector<std::vector<int>> next_open;  // Per exit, union-find parent towards the next open timestep
+
+    int firstOpen(int exit, int timestep);
+};
+
+#endif // ENMOD_EXIT_ASSIGNMENT_H
@@ -0,0 +1,52 @@
+#ifndef ENMOD_FEATURE_Q_LEARNING_SOLVER_H
+#define ENMOD_FEATURE_Q_LEARNING_SOLVER_H
+
+#include "Solver.h"
+#include "Policy.h"
+#include "FeatureQModel.h"
+#include "Random.h"
+#include <memory>
+
+// Linear action-value model over action-relative features instead of a per-cell table. The learned
+// weights do not depend on grid size or layout, so a model trained on one grid can be handed to a
+// solver for another grid (setModel) and used without retraining; DynamicFeatureQSim does that for
+// every grid state its hazards produce.
+class FeatureQLearningSolver : public Solver {
+public:
+    FeatureQLearningSolver(const Grid& grid_ref, const std::string& name = "FeatureQLearning");
+    void run() override;
+    Cost getEvacuationCost() const override;
+    void generateReport(std::ofstream& report_file) const override;
+
+    // Fits the model to rank the greedy action of a DP cost-to-exit field above the alternatives.
+    void fitToCostMap(const std::vector<std::vector<Cost>>& cost_map);
+    // Runs semi-gradient Q-learning episodes on this solver's grid, starting from the current weights
+    // (optional fine-tuning).
+    void train(int episodes);
+    // Greedy decision from the model; valid after run() or train().
+    Direction chooseAction(const Position& state) const;
+
+    // Supplies pre-trained weights; run() then only builds the policy. Without them every run() fits
+    // fresh weights to this grid's BIDP field, discarding earlier ones.
+    void setModel(const LinearQModel& trained_model) { model = trained_model; pretrained = true; }
+    const LinearQModel& getModel() const { return model; }
+
+private:
+    static constexpr int FIT_EPOCHS = 20;
+    static constexpr double REWARD_SCALE = 0.01; // Brings the +1000 exit reward into a range linear weights track well
+
+    LinearQModel model;
+    std::unique_ptr<FeatureGrid> features;
+    Policy policy;
+    Xoshiro256 rng;
+    bool pretrained = false;
+    int episodes_trained = 0;
+
+    float alpha = 0.01f;
+    double gamma = 0.9;
+    double epsilon = 0.1;
+
+    void buildFeatures();
+};
+
+#endif // ENMOD_FEATURE_Q_LEARNING_SOLVER_H
@@ -0,0 +1,59 @@
+#ifndef ENMOD_FEATURE_Q_MODEL_H
+#define ENMOD_FEATURE_Q_MODEL_H
+
+#include "Grid.h"
+#include "QTable.h"
+#include <vector>
+
+// Action-relative features of moving from a cell in one direction. They describe the target cell
+// and its surroundings rather than absolute positions, and need nothing but the grid itself, so
+// weights learned on one grid apply to any other.
+enum FeatureIndex {
+    FEATURE_BIAS,
+    FEATURE_BLOCKED,      // Wall or boundary: the move leaves the agent where it is
+    FEATURE_EXIT,
+    FEATURE_FIRE,
+    FEATURE_SMOKE,
+    FEATURE_DISTANCE,     // -1 / 0 / +1 as the move lowers, keeps or raises the time to the nearest exit
+    FEATURE_FIRE_NEARBY,  // Fraction of the 3x3 patch around the target that is on fire
+    FEATURE_SMOKE_NEARBY, // Fraction of the 3x3 patch around the target that is smoky
+    NUM_FEATURES
+};
+
+// Features of every cell of a grid, laid out [cell][feature][action]. The four action values of a
+// cell are then a chain of NUM_FEATURES multiply-adds on one 4-wide vector.
+class FeatureGrid {
+public:
+    // Times to the nearest exit come from one shortest-path pass over Grid::getMoveCost times, so
+    // building the features needs no planner.
+    explicit FeatureGrid(const Grid& grid);
+
+    int numCells() const { return rows * cols; }
+    int cellIndex(const Position& pos) const { return pos.row * cols + pos.col; }
+    const float* features(int cell) const { return &data[static_cast<std::size_t>(cell) * NUM_FEATURES * NUM_ACTIONS]; }
+
+private:
+    int rows;
+    int cols;
+    std::vector<float, AlignedAllocator<float, Q_TABLE_ALIGNMENT>> data;
+};
+
+// Linear action-value model Q(s, a) = w . phi(s, a) with one weight vector shared by all actions.
+class LinearQModel {
+public:
+    LinearQModel();
+
+    // Writes Q(s, a) for all NUM_ACTIONS actions of one FeatureGrid cell.
+    void evaluate(const float* features, float* q_values) const;
+    int bestAction(const float* features) const;
+    // Semi-gradient step: w += learning_rate * td_error * phi(s, action).
+    void update(const float* features, int action, float td_error, float learning_rate);
+
+    const float* getWeights() const { return weights; }
+    void setWeight(int feature, float value) { weights[feature] = value; }
+
+private:
+    alignas(16) float weights[NUM_FEATURES];
+};
+
+#endif // ENMOD_FEATURE_Q_MODEL_H
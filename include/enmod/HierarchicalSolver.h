@@ -1,7 +1,7 @@
 #ifndef ENMOD_HIERARCHICAL_SOLVER_H
 #define ENMOD_HIERARCHICAL_SOLVER_H
 
-#include "DynamicSolver.h"
+#include "DynamicSimulation.h"
 #include "Types.h"
 #include <vector>
 
@@ -11,14 +11,23 @@ public:
     void run() override;
     Cost getEvacuationCost() const override;
     void generateReport(std::ofstream& report_file) const override;
+    bool writeReplay(const std::string& path, std::uint64_t seed) const override;
 
 private:
+    // High-level BIDP planner that re-plans every 10 steps or when its plan runs out.
+    class ReplanningPolicy : public StepPolicy {
+    public:
+        void reset() override { current_plan.clear(); }
+        StepDecision decide(const Grid& current_grid, const Position& current_pos, EvacuationMode mode, int time_step) override;
+
+    private:
+        std::vector<Position> current_plan;
+    };
+
     std::vector<StepReport> history;
     Cost total_cost;
-    EvacuationMode current_mode;
-    std::vector<Position> current_plan;
-
-    void assessThreatAndSetMode(const Position& current_pos, const Grid& current_grid);
+    DynamicSimulation simulation;
+    ReplanningPolicy step_policy;
 };
 
 #endif // ENMOD_HIERARCHICAL_SOLVER_H
\ No newline at end of file
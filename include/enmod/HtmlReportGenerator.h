@@ -2,6 +2,7 @@
 #define ENMOD_HTML_REPORT_GENERATOR_H
 
 #include "Grid.h"
+#include "Profiler.h"
 #include "Solver.h"
 #include <string>
 #include <vector>
@@ -12,6 +13,7 @@ struct Result {
     Cost cost;
     double weighted_cost;
     double execution_time; 
+    ProfileData profile; // Empty unless built with ENMOD_ENABLE_PROFILING
 };
 
 class HtmlReportGenerator {
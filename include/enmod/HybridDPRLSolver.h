@@ -1,7 +1,7 @@
 #ifndef ENMOD_HYBRID_DP_RL_SOLVER_H
 #define ENMOD_HYBRID_DP_RL_SOLVER_H
 
-#include "DynamicSolver.h"
+#include "DynamicSimulation.h"
 #include "Types.h"
 #include "BIDP.h"
 #include "QLearningSolver.h"
@@ -11,18 +11,19 @@ class HybridDPRLSolver : public Solver {
 public:
     HybridDPRLSolver(const Grid& grid_ref);
     void run() override;
-    Direction getNextMove(const Position& current_pos, const Grid& current_grid); 
+    // The pre-trained policy used in PANIC mode, for PlanningSessions built on this solver
+    QLearningSolver& getRLPolicy() { return *rl_solver; }
     Cost getEvacuationCost() const override;
     void generateReport(std::ofstream& report_file) const override;
 
 private:
+    static constexpr int FINE_TUNE_EPISODES = 500; // After bootstrapping the RL agent from BIDP
+
     std::vector<StepReport> history;
     Cost total_cost;
     EvacuationMode current_mode;
 
     std::unique_ptr<QLearningSolver> rl_solver;
-
-    void assessThreatAndSetMode(const Position& current_pos, const Grid& current_grid);
 };
 
 #endif // ENMOD_HYBRID_DP_RL_SOLVER_H
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef ENMOD_JOB_RUNNER_H
+#define ENMOD_JOB_RUNNER_H
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Runs a batch of independent jobs on a fixed set of worker threads. Jobs are dealt round-robin
+// onto per-worker queues; each worker takes from the front of its own queue and, once that runs
+// dry, steals from the back of the others'. Uneven jobs (a 5x5 BIDP next to a 15x15 API) then
+// do not leave threads idle behind one long queue.
+class JobRunner {
+public:
+    explicit JobRunner(int num_workers = 0);
+
+    // Runs every job and returns once all have finished. If jobs throw, the exception of the first
+    // failing job in submission order is rethrown here after the rest have completed.
+    void run(const std::vector<std::function<void()>>& jobs);
+
+    int getNumWorkers() const { return num_workers; }
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::size_t> jobs;
+    };
+
+    int num_workers;
+
+    static bool popOwn(WorkQueue& queue, std::size_t& job);
+    static bool steal(WorkQueue& queue, std::size_t& job);
+};
+
+#endif // ENMOD_JOB_RUNNER_H
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <fstream>
+#include <mutex>
 
 enum class LogLevel { INFO, WARN, ERROR };
 
@@ -14,6 +15,7 @@ public:
 
 private:
     static std::ofstream log_file;
+    static std::mutex log_mutex; // Solvers log from worker threads
 };
 
 #endif // ENMOD_LOGGER_H
@@ -4,6 +4,14 @@
 #include "Grid.h"
 #include "HybridDPRLSolver.h"
 #include "MultiAgentReportGenerator.h"
+#include "AgentTransport.h"
+#include "ExitAssignment.h"
+#include "JobRunner.h"
+#include "PlanningSession.h"
+#include "CooperativePlanner.h"
+#include "ReplayLog.h"
+#include <functional>
+#include <map>
 #include <string>
 #include <vector>
 #include <memory>
@@ -13,10 +21,37 @@ struct Agent {
     Position position;
 };
 
+// Running totals over the timesteps simulated so far, for throughput measurements.
+struct MultiAgentStats {
+    int timesteps = 0;
+    long long decisions = 0;  // One per agent still inside at a timestep
+    double exchange_ms = 0.0; // Observations and commands through the transport
+    double decision_ms = 0.0; // Threat assessment, exit assignment and cooperative planning
+};
+
+// Evacuates a crowd of agents through one shared planning session. Each timestep runs in three
+// phases: every agent still inside exchanges its observation with the server; the server assesses
+// each agent's threat level and balances the crowd over the exits in parallel on a thread pool,
+// reading a snapshot of the session that nothing writes to meanwhile; then agents plan their
+// next few steps one after another, nearest to their exit first, through windowed cooperative
+// A*, so no two ever collide. The result does not depend on the number of threads.
 class MultiAgentCPSController {
 public:
-    MultiAgentCPSController(const json& initial_config, const std::string& report_path, int num_agents = 5);
+    // num_workers: planning threads, 0 for one per hardware thread.
+    MultiAgentCPSController(const json& initial_config, const std::string& report_path, int num_agents = 5, int num_workers = 0);
     void run_simulation();
+    // Advances the simulation by one timestep without recording it in the report. Returns true
+    // once every agent has reached an exit.
+    bool step(int timestep);
+    // Records every step from here on to a ReplayLog at path; call before the first step.
+    // run_simulation records to <report_path>/multi_agent.replay on its own, ending with a step that
+    // holds the final positions.
+    void recordReplay(const std::string& path);
+
+    std::size_t getNumAgents() const { return agents.size(); }
+    const std::vector<Agent>& getAgents() const { return agents; }
+    int getNumWorkers() const { return workers.getNumWorkers(); }
+    const MultiAgentStats& getStats() const { return stats; }
 
 private:
     Grid master_grid;
@@ -24,10 +59,43 @@ private:
     std::unique_ptr<HybridDPRLSolver> solver;
     MultiAgentReportGenerator report_generator;
     std::string report_path;
+    std::unique_ptr<AgentTransport> transport;
+    std::map<std::string, EnvironmentDeltaEncoder> environment_feeds;  // Agent side, one stream per agent
+
+    // Server side: one planning session shared by every agent, so each cost field is planned once
+    // for all of them, and a cooperative planner that keeps them out of each other's way.
+    PlanningSession session;
+    CooperativePlanner planner;
+    ExitAssignment exit_assignment;
+    std::vector<int> agent_exits; // Exit each agent is headed for, indexed like agents; -1 for none yet
+    JobRunner workers;
+    MultiAgentStats stats;
+
+    // Per-timestep scratch, one entry per agent still inside, reused from step to step
+    std::vector<std::size_t> active;
+    std::vector<char> synced; // The server's session accepted the agent's environment update
+    std::vector<EvacuationMode> modes;
+    std::vector<Position> positions;
+    std::vector<std::pair<int, int>> order; // (priority, k): planning order of the cooperative pass
+    std::vector<int> exit_distances; // exit_distances[k * exits + e]
+    std::vector<int> exits;
+    std::vector<Direction> moves;
+
+    // Replay recording, indexed like agents
+    std::unique_ptr<ReplayRecorder> replay;
+    std::vector<Position> replay_positions;
+    std::vector<Direction> replay_moves;
+    std::vector<EvacuationMode> replay_modes;
 
-    // Added missing declarations
-    void write_input_file(int timestep, const Agent& agent);
-    Direction read_output_file(int timestep, const Agent& agent);
+    void placeAgents(int num_agents, const json& initial_config);
+    void applyEvents(int timestep);
+    bool advance(int timestep);
+    void decideMoves();
+    void assignExits();
+    // Runs body(begin, end) over slices of the active agents on the worker threads.
+    void forEachActive(const std::function<void(std::size_t, std::size_t)>& body);
+    bool observe(int timestep, const Agent& agent);
+    Direction command(int timestep, const Agent& agent, Direction move, bool resync);
 };
 
-#endif // ENMOD_MULTI_AGENT_CPS_CONTROLLER_H
\ No newline at end of file
+#endif // ENMOD_MULTI_AGENT_CPS_CONTROLLER_H
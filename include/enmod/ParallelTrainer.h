@@ -0,0 +1,38 @@
+#ifndef ENMOD_PARALLEL_TRAINER_H
+#define ENMOD_PARALLEL_TRAINER_H
+
+#include "RLSolver.h"
+#include <vector>
+
+struct TrainingStats {
+    int episodes = 0;
+    int workers = 0;
+    bool converged = false;
+    double seconds = 0.0;
+    double episodes_per_second = 0.0;
+    // Largest |dQ| applied to the shared table at each merge; a shrinking trace means convergence.
+    std::vector<double> merge_deltas;
+    // Mean steps, return and exit rate of the last round's episodes across all workers
+    TrainingSummary last_round;
+};
+
+// Runs episodes on several worker copies of an RL solver at once. Every worker learns on its own
+// clone of the solver for sync_interval episodes, after which the clones are merged back into the
+// solver (RLSolver::mergeWorkers) and cloned again for the next round. Worker streams come from
+// the solver's own generator and the merge goes in worker order, so a fixed seed and worker count
+// reproduce the table exactly.
+class ParallelTrainer {
+public:
+    explicit ParallelTrainer(int num_workers = 0, int sync_interval = 250);
+
+    // Trains up to options.max_episodes episodes. With options.check_interval > 0 every round is a
+    // convergence check as in RLSolver::trainUntilConverged: training stops once the merged greedy
+    // policy stays unchanged for options.patience rounds. options.on_episode is not called.
+    TrainingStats train(RLSolver& solver, const TrainingOptions& options);
+
+private:
+    int num_workers;
+    int sync_interval;
+};
+
+#endif // ENMOD_PARALLEL_TRAINER_H
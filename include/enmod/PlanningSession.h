@@ -0,0 +1,66 @@
+#ifndef ENMOD_PLANNING_SESSION_H
+#define ENMOD_PLANNING_SESSION_H
+
+#include "BIDP.h"
+#include "EnvironmentDelta.h"
+#include "QLearningSolver.h"
+#include <memory>
+
+// Server-side planning state for one scenario that lives across timesteps: the grid, one BIDP
+// cost-to-exit field per evacuation mode (the mode changes how Costs compare, and so the field),
+// and the pre-trained RL policy used in PANIC mode. Environment updates are applied to the grid in
+// place and mark the fields stale; a field is rebuilt the next time its mode is asked for, so
+// between hazards every decision is a lookup of the four neighbours. Any number of agents can
+// share one session; keeping them off each other's cells is up to the caller (see CooperativePlanner).
+//
+// nextMove() does everything for one agent. For many agents the decision splits into steps:
+// assessMode() and getField() only read the session and may run on several threads at once,
+// provided prepareField() has first been called for every mode they will be asked about.
+class PlanningSession {
+public:
+    // rl_policy must outlive the session.
+    explicit PlanningSession(const QLearningSolver& rl_policy);
+    PlanningSession(const Grid& grid, const QLearningSolver& rl_policy);
+
+    // As EnvironmentMirror::apply: false, with nothing changed, if the update does not follow on.
+    bool apply(const EnvironmentUpdate& update, const std::string& sender = "");
+    bool isReady() const { return environment.isReady(); }
+    const Grid& getGrid() const { return environment.getGrid(); }
+    // Changes whenever an update changes the grid.
+    std::uint64_t getVersion() const { return environment.getVersion(); }
+
+    // The hybrid DP-RL decision: RL policy in PANIC, otherwise steepest descent on the field.
+    // Sets Cost::current_mode to the assessed mode.
+    Direction nextMove(const Position& current_pos);
+
+    EvacuationMode assessMode(const Position& current_pos) const;
+    void prepareField(EvacuationMode field_mode);
+    // One field per exit, for agents that have been assigned a particular exit.
+    void prepareExitFields(EvacuationMode field_mode);
+    int getNumExits() const { return static_cast<int>(environment.getGrid().getExitPositions().size()); }
+    // Steps from pos to the exit along its NORMAL field, MAX_COST if cut off. Requires prepareExitFields(NORMAL).
+    int exitDistance(const Position& pos, int exit) const;
+    // Requires prepareField(field_mode), or prepareExitFields(field_mode) for one exit's field (exit >= 0).
+    const std::vector<std::vector<Cost>>& getField(EvacuationMode field_mode, int exit = -1) const;
+    // The RL policy's greedy move, used in PANIC.
+    Direction panicMove(const Position& current_pos) const;
+
+    EvacuationMode getMode() const { return mode; }
+    int getFieldRebuilds() const { return field_rebuilds; }
+
+private:
+    static constexpr int NUM_MODES = 3;
+
+    EnvironmentMirror environment;
+    const QLearningSolver& rl_policy;
+    std::unique_ptr<BIDP> fields[NUM_MODES];   // Planners bound to the environment's grid
+    std::uint64_t field_versions[NUM_MODES] = {}; // Environment version each field was planned on
+    std::vector<std::unique_ptr<BIDP>> exit_fields[NUM_MODES];
+    std::uint64_t exit_field_versions[NUM_MODES] = {};
+    EvacuationMode mode = EvacuationMode::NORMAL;
+    int field_rebuilds = 0;
+
+    const std::vector<std::vector<Cost>>& costField(EvacuationMode field_mode);
+};
+
+#endif // ENMOD_PLANNING_SESSION_H
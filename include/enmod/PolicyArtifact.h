@@ -0,0 +1,50 @@
+#ifndef ENMOD_POLICY_ARTIFACT_H
+#define ENMOD_POLICY_ARTIFACT_H
+
+#include "Grid.h"
+#include "QTable.h"
+#include <cstdint>
+#include <string>
+
+// On-disk layout of a trained action-value table. The header is followed by the Q-values
+// (numCells * NUM_ACTIONS QValues, starting at byte 64) and then one visited flag per cell.
+struct PolicyArtifactHeader {
+    char magic[8];              // "ENMODQT\0"
+    std::uint32_t version;
+    std::uint32_t value_size;   // sizeof(QValue) of the build that wrote the file
+    std::int32_t rows;
+    std::int32_t cols;
+    std::int32_t num_actions;
+    std::uint32_t reserved0;
+    std::uint64_t grid_hash;    // PolicyArtifact::gridHash of the training grid
+    std::uint64_t payload_hash; // FNV-1a over everything after the header
+    std::uint64_t training_hash; // RLSolver::trainingHash of the run that produced the table
+    std::uint8_t reserved[8];
+};
+static_assert(sizeof(PolicyArtifactHeader) == 64, "policy artifact header must stay 64 bytes");
+
+// Versioned binary persistence for pre-trained Q-tables. Artifacts are keyed by a hash of the
+// grid content and one of the training run's settings, so a table is only reused for the exact
+// layout and hazards it was trained on, and only where training again would produce it.
+// Loading maps the file read-only and copies the payload straight into the table.
+class PolicyArtifact {
+public:
+    static constexpr std::uint32_t FORMAT_VERSION = 2;
+
+    // Directory used by cachePath(); created on first save.
+    inline static std::string cache_directory = "policy_cache";
+
+    // Hash of everything the RL reward model depends on: dimensions, cell types, start and exits.
+    static std::uint64_t gridHash(const Grid& grid);
+    // FNV-1a of size bytes, continuing from hash; the building block of the keys above.
+    static std::uint64_t hashBytes(const void* data, std::size_t size, std::uint64_t hash = 0xCBF29CE484222325ULL);
+    static std::string cachePath(const std::string& solver_name, const Grid& grid, std::uint64_t training_hash);
+
+    // Writes the table atomically (temporary file + rename). Returns false on I/O failure.
+    static bool save(const std::string& path, const QTable& table, std::uint64_t grid_hash, std::uint64_t training_hash);
+    // Returns false, leaving the table untouched, if the file is missing, truncated, corrupt,
+    // from another format version or precision, or trained on a different grid or settings.
+    static bool load(const std::string& path, std::uint64_t grid_hash, std::uint64_t training_hash, QTable& table);
+};
+
+#endif // ENMOD_POLICY_ARTIFACT_H
@@ -1,7 +1,7 @@
 #ifndef ENMOD_POLICY_BLENDING_SOLVER_H
 #define ENMOD_POLICY_BLENDING_SOLVER_H
 
-#include "DynamicSolver.h"
+#include "DynamicSimulation.h"
 #include "Types.h"
 #include "QLearningSolver.h"
 #include <memory>
@@ -12,14 +12,26 @@ public:
     void run() override;
     Cost getEvacuationCost() const override;
     void generateReport(std::ofstream& report_file) const override;
+    bool writeReplay(const std::string& path, std::uint64_t seed) const override;
 
 private:
+    static constexpr int FINE_TUNE_EPISODES = 500; // After bootstrapping the RL agent from BIDP
+
+    // DP in NORMAL mode, RL in PANIC mode and the better of the two by DP cost in ALERT mode.
+    class BlendingPolicy : public StepPolicy {
+    public:
+        explicit BlendingPolicy(const QLearningSolver& rl_solver) : rl_solver(rl_solver) {}
+        StepDecision decide(const Grid& current_grid, const Position& current_pos, EvacuationMode mode, int time_step) override;
+
+    private:
+        const QLearningSolver& rl_solver;
+    };
+
     std::vector<StepReport> history;
     Cost total_cost;
-    EvacuationMode current_mode;
     std::unique_ptr<QLearningSolver> rl_solver;
-
-    void assessThreatAndSetMode(const Position& current_pos, const Grid& current_grid);
+    DynamicSimulation simulation;
+    BlendingPolicy step_policy;
 };
 
 #endif // ENMOD_POLICY_BLENDING_SOLVER_H
\ No newline at end of file
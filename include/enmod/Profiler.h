@@ -0,0 +1,110 @@
+#ifndef ENMOD_PROFILER_H
+#define ENMOD_PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+
+// Phase timers and event counters for the solvers. The ENMOD_PROFILE_* macros compile to nothing
+// unless the build defines ENMOD_ENABLE_PROFILING, so instrumented hot loops cost nothing by default.
+// Data is collected per thread: a comparison job resets it, runs one solver and takes the totals.
+
+enum ProfilePhase {
+    PHASE_PLANNER_SETUP, // Cost-map allocation and queue seeding
+    PHASE_PLANNING,      // Dijkstra search or DP sweeps
+    PHASE_NEIGHBOR_SCAN,
+    PHASE_HISTORY,       // Copying the grid into a StepReport
+    PHASE_TRAINING,      // RL episodes
+    PHASE_REPORT,
+    NUM_PROFILE_PHASES
+};
+
+enum ProfileCounter {
+    COUNTER_HEAP_PUSHES,
+    COUNTER_HEAP_POPS,
+    COUNTER_RELAXATIONS, // Edges that improved a tentative cost
+    COUNTER_SWEEPS,      // Full passes of value or policy iteration
+    COUNTER_EPISODES,
+    COUNTER_SIM_STEPS,
+    NUM_PROFILE_COUNTERS
+};
+
+enum HardwareCounter {
+    HW_CYCLES,
+    HW_CACHE_MISSES,
+    HW_BRANCH_MISSES,
+    NUM_HARDWARE_COUNTERS
+};
+
+struct ProfileData {
+    double phase_ms[NUM_PROFILE_PHASES] = {};
+    std::uint64_t phase_calls[NUM_PROFILE_PHASES] = {};
+    std::uint64_t counters[NUM_PROFILE_COUNTERS] = {};
+    std::uint64_t hardware[NUM_HARDWARE_COUNTERS] = {};
+    bool has_hardware = false; // perf_event counters were available for this run
+};
+
+class Profiler {
+public:
+#ifdef ENMOD_ENABLE_PROFILING
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    static ProfileData& current() { return data; }
+    // Returns this thread's totals and starts a fresh collection.
+    static ProfileData take();
+
+    static const char* phaseName(int phase);
+    static const char* counterName(int counter);
+    static const char* hardwareName(int counter);
+
+private:
+    inline static thread_local ProfileData data;
+};
+
+// Adds the lifetime of the object to one phase of the calling thread's profile.
+class ScopedPhase {
+public:
+    explicit ScopedPhase(ProfilePhase phase) : phase(phase), start(std::chrono::steady_clock::now()) {}
+    ~ScopedPhase() {
+        ProfileData& data = Profiler::current();
+        data.phase_ms[phase] += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        ++data.phase_calls[phase];
+    }
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+private:
+    ProfilePhase phase;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Cycle, cache-miss and branch-miss counts of the calling thread between construction and
+// stop(), read through Linux perf_event. Elsewhere, or when the kernel refuses access (for
+// example perf_event_paranoid in containers), stop() reports nothing and leaves has_hardware false.
+class HardwareCounters {
+public:
+    HardwareCounters();
+    ~HardwareCounters();
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+    void stop(ProfileData& into);
+
+private:
+    int fds[NUM_HARDWARE_COUNTERS] = {-1, -1, -1}; // fds[HW_CYCLES] leads the group
+};
+
+#define ENMOD_PROFILE_CONCAT_INNER(a, b) a##b
+#define ENMOD_PROFILE_CONCAT(a, b) ENMOD_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef ENMOD_ENABLE_PROFILING
+#define ENMOD_PROFILE_PHASE(phase) ScopedPhase ENMOD_PROFILE_CONCAT(enmod_profile_phase_, __LINE__)(phase)
+#define ENMOD_PROFILE_COUNT(counter, n) (Profiler::current().counters[counter] += static_cast<std::uint64_t>(n))
+#else
+#define ENMOD_PROFILE_PHASE(phase) ((void)0)
+#define ENMOD_PROFILE_COUNT(counter, n) ((void)0)
+#endif
+
+#endif // ENMOD_PROFILER_H
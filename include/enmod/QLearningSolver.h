@@ -2,17 +2,42 @@
 #define ENMOD_Q_LEARNING_SOLVER_H
 
 #include "RLSolver.h"
+#include "ReplayBuffer.h"
 
 class QLearningSolver : public RLSolver {
 public:
     QLearningSolver(const Grid& grid_ref, const std::string& name = "QLearning");
     void run() override; // This will be the training step
     Cost getEvacuationCost() const override;
+    std::unique_ptr<RLSolver> clone() const override;
     void generateReport(std::ofstream& report_file) const override;
     
     void train(int episodes) override;
     Direction chooseAction(const Position& state) override;
     void update(const Position& s, Direction a, double r, const Position& s_next, Direction a_next) override;
+    void chooseActionBatch(int lanes, const int* cells, int* actions) override;
+    void updateBatch(int lanes, const int* cells, const int* actions, const double* rewards,
+                     const int* next_cells, const int* next_actions) override;
+
+    // Turns on prioritized experience replay and Dyna-Q planning: every real update is followed by
+    // options.replay_updates replays of stored transitions and options.planning_steps model updates.
+    void enableReplay(const ReplayOptions& options = ReplayOptions());
+    bool replayEnabled() const { return replay_enabled; }
+
+protected:
+    // One-step Q-learning backup on cell indices; returns the TD error before the update.
+    double backup(int cell, int action, double reward, int next_cell);
+    // Watkins Q(lambda) step over the sparse trace set; used instead of backup() when lambda > 0.
+    void traceBackup(const Transition& transition, int next_action);
+    // Stores a real transition, then runs the prioritized replays and Dyna-Q planning updates.
+    void replayAndPlan(const Transition& transition);
+    void writeReplaySummary(std::ofstream& report_file) const;
+
+private:
+    bool replay_enabled = false;
+    ReplayOptions replay_options;
+    PrioritizedReplayBuffer replay_buffer;
+    DynaModel model;
 };
 
 #endif // ENMOD_Q_LEARNING_SOLVER_H
\ No newline at end of file
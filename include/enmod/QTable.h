@@ -0,0 +1,79 @@
+#ifndef ENMOD_Q_TABLE_H
+#define ENMOD_Q_TABLE_H
+
+#include "Types.h"
+#include <vector>
+#include <cstddef>
+#include <new>
+
+// Q-values are double by default; build with ENMOD_Q_SINGLE_PRECISION to halve the table footprint.
+#ifdef ENMOD_Q_SINGLE_PRECISION
+using QValue = float;
+#else
+using QValue = double;
+#endif
+
+constexpr int NUM_ACTIONS = 4; // UP, DOWN, LEFT, RIGHT
+constexpr std::size_t Q_TABLE_ALIGNMENT = 64;
+
+template <typename T, std::size_t Alignment>
+struct AlignedAllocator {
+    using value_type = T;
+    template <typename U> struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, std::size_t) { ::operator delete(p, std::align_val_t(Alignment)); }
+
+    template <typename U> bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+// Dense action-value table indexed by cell id (row * cols + col) and action.
+// The values of one cell are contiguous so a greedy lookup touches a single cache line,
+// and visitation is tracked in a separate flag array.
+class QTable {
+public:
+    QTable() = default;
+    QTable(int rows, int cols, QValue initial_value = 0);
+
+    void reset(int rows, int cols, QValue initial_value = 0);
+
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    int numCells() const { return rows * cols; }
+
+    int cellIndex(const Position& pos) const { return pos.row * cols + pos.col; }
+    Position cellPosition(int cell) const { return {cell / cols, cell % cols}; }
+
+    QValue* values(int cell) { return &data[static_cast<std::size_t>(cell) * NUM_ACTIONS]; }
+    const QValue* values(int cell) const { return &data[static_cast<std::size_t>(cell) * NUM_ACTIONS]; }
+    QValue& at(int cell, int action) { return data[static_cast<std::size_t>(cell) * NUM_ACTIONS + action]; }
+    QValue at(int cell, int action) const { return data[static_cast<std::size_t>(cell) * NUM_ACTIONS + action]; }
+
+    bool isVisited(int cell) const { return visited[cell] != 0; }
+    void markVisited(int cell) { visited[cell] = 1; }
+
+    // Index of the first maximal action, matching std::max_element tie-breaking.
+    int bestAction(int cell) const {
+        const QValue* q = values(cell);
+        int best = 0;
+        for (int a = 1; a < NUM_ACTIONS; ++a) {
+            if (q[a] > q[best]) best = a;
+        }
+        return best;
+    }
+    QValue maxValue(int cell) const { return values(cell)[bestAction(cell)]; }
+
+private:
+    int rows = 0;
+    int cols = 0;
+    std::vector<QValue, AlignedAllocator<QValue, Q_TABLE_ALIGNMENT>> data;
+    std::vector<unsigned char> visited;
+};
+
+#endif // ENMOD_Q_TABLE_H
@@ -3,10 +3,45 @@
 
 #include "Solver.h"
 #include "Policy.h"
+#include "QTable.h"
+#include "Random.h"
+#include "EligibilityTraces.h"
 #include <vector>
-#include <map>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
 
-using ValueTable = std::map<Position, std::vector<double>>;
+using ValueTable = QTable;
+
+class BatchEnvironment;
+
+struct EpisodeMetrics {
+    int episode = 0;
+    int steps = 0;
+    double episode_return = 0.0; // Undiscounted sum of rewards
+    double max_delta_q = 0.0;    // Largest single |dQ| applied during the episode
+    bool reached_exit = false;
+};
+
+struct TrainingOptions {
+    int max_episodes = 5000;
+    int check_interval = 50;       // Episodes between greedy-policy comparisons; 0 disables early stopping
+    int patience = 3;              // Consecutive unchanged checks required to stop
+    double delta_tolerance = 0.0;  // If > 0, the window's max |dQ| must also fall below this
+    bool require_greedy_exit = false; // Also require the greedy policy to lead from the start to an exit
+    std::function<void(const EpisodeMetrics&)> on_episode; // Optional per-episode metrics sink
+};
+
+struct TrainingSummary {
+    int episodes = 0;
+    bool converged = false;
+    // Averages over the last check window
+    double mean_steps = 0.0;
+    double mean_return = 0.0;
+    double exit_rate = 0.0;
+    double max_delta_q = 0.0;
+};
 
 class RLSolver : public Solver {
 public:
@@ -17,18 +52,116 @@ public:
     // RL-specific methods for learning
     virtual void update(const Position& s, Direction a, double r, const Position& s_next, Direction a_next) = 0;
     virtual Direction chooseAction(const Position& state) = 0;
+    // Best learned action without exploration, for acting on a trained table; STAY where the
+    // table has never visited the state. Leaves the generator untouched.
+    Direction greedyAction(const Position& state) const;
+    // Best action of every visited cell, -1 for the rest.
+    std::vector<int> greedyActions() const;
+    // Whether the greedy actions lead from the start to an exit without revisiting a cell.
+    bool greedyReachesExit() const;
     const Policy& getPolicy(); 
 
+    // Trains a fixed number of episodes, one after another unless setBatchLanes turned batching on.
+    virtual void train(int episodes);
+    // Trains `episodes` episodes in lock-step across `lanes` concurrent episodes on a tabulated environment.
+    void trainBatch(int episodes, int lanes = BATCH_LANES);
+
+    // Cell-indexed batch forms of chooseAction/update used by trainBatch. The defaults
+    // forward to the scalar methods; learners override them with tight table loops.
+    virtual void chooseActionBatch(int lanes, const int* cells, int* actions);
+    virtual void updateBatch(int lanes, const int* cells, const int* actions, const double* rewards,
+                             const int* next_cells, const int* next_actions);
+
+    // Seeds the learner from a DP cost-to-exit field (BIDP or AVI cost map) instead of starting from zero.
+    virtual void initializeFromCostMap(const std::vector<std::vector<Cost>>& cost_map);
+    // Trains until the greedy policy stays unchanged for `patience` consecutive checks or the
+    // episode budget is spent, reporting every episode to options.on_episode.
+    TrainingSummary trainUntilConverged(const TrainingOptions& options);
+    // The training of run(): trainUntilConverged on this thread, or a ParallelTrainer with the same
+    // options when setTrainingWorkers asked for more than one worker.
+    TrainingSummary runTraining(const TrainingOptions& options);
+    // Short convergence-checked training run after initializeFromCostMap. Returns the episodes used.
+    int fineTune(int max_episodes, int check_interval = 50, int patience = 3);
+    const TrainingSummary& getTrainingSummary() const { return training_summary; }
+
+    // Independent copy of the learner, used as a worker by the ParallelTrainer
+    virtual std::unique_ptr<RLSolver> clone() const = 0;
+    // Averages what the workers (clones of this learner) learned back into it, for the
+    // ParallelTrainer's merge step, and returns the largest change to a value_table entry.
+    virtual double mergeWorkers(const std::vector<const RLSolver*>& workers);
+    // Threads run() spreads its training over through a ParallelTrainer; 1, the default, trains on
+    // the calling thread.
+    void setTrainingWorkers(int workers) { training_workers = std::max(1, workers); }
+    int getTrainingWorkers() const { return training_workers; }
+
+    // Hash of everything but the grid that a fineTune(max_episodes, check_interval, patience) run
+    // depends on: this solver's seed stream under run_seed, its hyperparameters and the budget.
+    std::uint64_t trainingHash(int max_episodes, int check_interval = 50, int patience = 3) const;
+    // Persist or restore the learned value table as a PolicyArtifact keyed by this solver's grid and
+    // training_hash. loadValueTable also rebuilds the greedy policy; it returns false if no usable
+    // artifact exists.
+    bool saveValueTable(const std::string& path, std::uint64_t training_hash) const;
+    bool loadValueTable(const std::string& path, std::uint64_t training_hash);
+
+    ValueTable& getValueTable() { return value_table; }
+    const ValueTable& getValueTable() const { return value_table; }
+
+    // Enables lambda-return updates with sparse eligibility traces (Watkins Q(lambda) for Q-learning,
+    // SARSA(lambda) for SARSA); 0 restores one-step TD. While it is on, training runs episodes one
+    // after another, because trainBatch interleaves them.
+    void setTraceDecay(double trace_lambda) { lambda = trace_lambda; traces.clear(); }
+    double getTraceDecay() const { return lambda; }
+    // With lanes > 0, train and trainUntilConverged run one-step episodes in lock-step across up to
+    // that many lanes through trainBatch's loop. That trades the sequential episode order (and so the
+    // exact table a seed produces) for throughput on large grids. 0, the default, keeps them sequential.
+    void setBatchLanes(int lanes) { batch_lanes = std::max(0, lanes); }
+    int getBatchLanes() const { return batch_lanes; }
+
+    // Reseeds this solver's action-selection generator.
+    void seed(std::uint64_t seed_value) { rng.seed(seed_value); }
+    Xoshiro256& getRng() { return rng; }
+
+    // Run-level seed; every solver derives its own stream from it and its name at construction.
+    inline static std::uint64_t run_seed = 0x5EED;
+
 protected:
+    // Rebuilds any state a learner derives from value_table. Called before training starts and after
+    // the table is replaced wholesale (artifact load, ParallelTrainer merge).
+    virtual void syncWithValueTable() {}
+    // Called before every training episode; clears the eligibility traces by default.
+    virtual void onEpisodeStart() { traces.clear(); }
+    // Applies alpha * td_error * e(s,a) to every traced pair.
+    void applyTraces(double td_error);
     void generatePolicyFromValueTable();
-    virtual void train(int episodes); 
+    // Discounted return of following the cost map's greedy path from every cell under the RL reward model.
+    std::vector<double> stateValuesFromCostMap(const std::vector<std::vector<Cost>>& cost_map) const;
+    // Follows the greedy actions from the start cell; false if they stop short of an exit, step
+    // into an unvisited cell or come back to a cell they already left.
+    bool greedyReachesExit(const BatchEnvironment& env, int horizon) const;
+    EpisodeMetrics runEpisode(const BatchEnvironment& env, int horizon);
+    // Trains `episodes` episodes and returns their averaged metrics. With batch_lanes set, one-step
+    // learners run them in lock-step through runBatch unless every episode has to be reported to
+    // on_episode.
+    TrainingSummary runEpisodes(const BatchEnvironment& env, int horizon, int first_episode, int episodes,
+                                const std::function<void(const EpisodeMetrics&)>& on_episode);
+    TrainingSummary runBatch(const BatchEnvironment& env, int horizon, int episodes, int lanes);
+    void writeTrainingSummary(std::ofstream& report_file) const;
 
     ValueTable value_table;
     Policy policy;
+    Xoshiro256 rng;
+    TrainingSummary training_summary;
+    EligibilityTraces traces;
     
     double alpha = 0.1;
     double gamma = 0.9;
     double epsilon = 0.1;
+    double lambda = 0.0;
+    int batch_lanes = 0;
+    int training_workers = 1;
+
+    static constexpr int BATCH_LANES = 256;
+    static constexpr int EPISODES_PER_LANE = 16; // Episodes each lane runs in turn when runEpisodes batches a budget
 };
 
 #endif // ENMOD_RL_SOLVER_H
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef ENMOD_RANDOM_H
+#define ENMOD_RANDOM_H
+
+#include <cstdint>
+#include <string>
+
+// SplitMix64 step, used to expand a single seed into generator state and to derive sub-seeds.
+inline std::uint64_t splitMix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Combines a run-level seed with a stream name so that every solver gets its own sequence.
+inline std::uint64_t deriveSeed(std::uint64_t run_seed, const std::string& stream) {
+    std::uint64_t hash = 0xCBF29CE484222325ULL; // FNV-1a
+    for (unsigned char ch : stream) {
+        hash ^= ch;
+        hash *= 0x100000001B3ULL;
+    }
+    std::uint64_t state = run_seed ^ hash;
+    return splitMix64(state);
+}
+
+// xoshiro256** generator. Small, fast and satisfies UniformRandomBitGenerator,
+// so it can also drive the <random> distributions.
+class Xoshiro256 {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Xoshiro256(std::uint64_t seed_value = 0) { seed(seed_value); }
+
+    void seed(std::uint64_t seed_value) {
+        std::uint64_t sm = seed_value;
+        for (auto& word : s) word = splitMix64(sm);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~static_cast<result_type>(0); }
+
+    result_type operator()() {
+        const std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Uniform double in [0, 1).
+    double uniform() { return static_cast<double>(operator()() >> 11) * 0x1.0p-53; }
+
+    // Uniform integer in [0, n) using the multiply-shift reduction.
+    int nextInt(int n) {
+        return static_cast<int>(((operator()() >> 32) * static_cast<std::uint64_t>(n)) >> 32);
+    }
+
+private:
+    std::uint64_t s[4];
+
+    static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+#endif // ENMOD_RANDOM_H
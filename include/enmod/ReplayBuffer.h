@@ -0,0 +1,69 @@
+#ifndef ENMOD_REPLAY_BUFFER_H
+#define ENMOD_REPLAY_BUFFER_H
+
+#include "Random.h"
+#include <vector>
+
+// One observed step, in cell/action indices as used by QTable and BatchEnvironment.
+struct Transition {
+    int cell = 0;
+    int action = 0;
+    double reward = 0.0;
+    int next_cell = 0;
+};
+
+struct ReplayOptions {
+    int capacity = 4096;           // Transitions kept; the oldest is overwritten when full
+    int replay_updates = 4;        // Prioritized replays after every real step
+    int planning_steps = 4;        // Dyna model updates after every real step
+    double priority_exponent = 0.6; // 0 = uniform sampling, 1 = fully proportional to |TD error|
+};
+
+// Fixed-capacity ring buffer of transitions, sampled in proportion to their last TD error.
+// Priorities live in a sum tree (internal nodes at [1, capacity), leaves at [capacity, 2*capacity)),
+// so adding, sampling and reprioritizing are all O(log capacity) with no allocation after construction.
+class PrioritizedReplayBuffer {
+public:
+    PrioritizedReplayBuffer() = default;
+    PrioritizedReplayBuffer(int capacity, double priority_exponent);
+
+    void clear();
+    int size() const { return count; }
+    int capacity() const { return static_cast<int>(transitions.size()); }
+    bool empty() const { return count == 0; }
+
+    // Stores a transition at the maximum priority seen so far, so it is replayed at least once soon.
+    void add(const Transition& transition);
+    // Returns the slot of a transition drawn with probability priority / total.
+    int sample(Xoshiro256& rng) const;
+    const Transition& get(int slot) const { return transitions[slot]; }
+    void updatePriority(int slot, double td_error);
+
+private:
+    std::vector<Transition> transitions;
+    std::vector<double> tree;
+    double exponent = 0.6;
+    double max_priority = 1.0;
+    int next_slot = 0;
+    int count = 0;
+
+    void setPriority(int slot, double priority);
+};
+
+// Deterministic tabular model for Dyna-Q planning: the most recent reward and successor seen for each
+// (cell, action). Because it keeps only the latest outcome, it follows hazards as they spread.
+class DynaModel {
+public:
+    void reset(int num_cells);
+    void record(const Transition& transition);
+    bool empty() const { return observed.empty(); }
+    // Uniformly picks a previously observed (cell, action) and returns its modelled outcome.
+    Transition sample(Xoshiro256& rng) const;
+
+private:
+    std::vector<int> next_cells; // -1 until the pair has been observed
+    std::vector<double> rewards;
+    std::vector<int> observed;   // Observed (cell * NUM_ACTIONS + action) keys
+};
+
+#endif // ENMOD_REPLAY_BUFFER_H
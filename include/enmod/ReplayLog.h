@@ -0,0 +1,100 @@
+#ifndef ENMOD_REPLAY_LOG_H
+#define ENMOD_REPLAY_LOG_H
+
+#include "Grid.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Compact binary record of one evacuation run: what the agents did, not how they decided it, so a
+// replay rebuilds any timestep without planning. All integers are little-endian.
+//
+//   header    magic "ERPL" | version u8 | 3 pad | seed u64 | grid hash u64 | agents u32 |
+//             config length u32 | scenario config as CBOR | start positions (agents x (row i32 | col i32))
+//   hazard    type u8 = 1 | timestep i32 | index into the config's "dynamic_events" u32
+//   keyframe  type u8 = 2 | timestep i32 | positions (agents x (row i32 | col i32))
+//   step      type u8 = 3 | timestep i32 | agents x (move u8 | mode << 4)
+//
+// A hazard is applied at the start of its timestep, before the agents decide. Steps are recorded
+// for consecutive timesteps from 0; a finished run ends with one in which every agent stays put,
+// so its state holds where the run ended. Between keyframes an agent's position follows from its
+// moves as Grid::getNextPosition would have it; the recorder writes a keyframe every
+// KEYFRAME_INTERVAL steps and whenever a position does not follow that way, so any timestep is at
+// most KEYFRAME_INTERVAL steps of byte reads away from an exact state.
+struct ReplayState {
+    int timestep;
+    Grid grid;                             // Hazards up to and including timestep applied
+    std::vector<Position> positions;       // At the start of timestep
+    std::vector<Direction> moves;          // Carried out during timestep; STAY for agents already out
+    std::vector<EvacuationMode> modes;
+};
+
+class ReplayRecorder {
+public:
+    static constexpr std::uint8_t VERSION = 1;
+    static constexpr int KEYFRAME_INTERVAL = 64;
+
+    // Starts a log at path, replacing any earlier one. Throws std::runtime_error if it cannot be
+    // created.
+    ReplayRecorder(const std::string& path, const json& config, std::uint64_t seed, const std::vector<Position>& starts);
+    ~ReplayRecorder();
+    ReplayRecorder(const ReplayRecorder&) = delete;
+    ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+    void recordHazard(int timestep, std::size_t event_index);
+    // positions, moves and modes hold every agent, in the order of starts.
+    void recordStep(int timestep, const std::vector<Position>& positions, const std::vector<Direction>& moves,
+                    const std::vector<EvacuationMode>& modes);
+    void flush();
+
+    // FNV-1a of the config's compact dump; a replay only fits the scenario it was recorded on.
+    static std::uint64_t hashConfig(const json& config);
+
+private:
+    std::ofstream out;
+    std::vector<Position> expected; // Where the last step's moves lead
+    int steps_since_keyframe = 0;
+    std::vector<std::uint8_t> buffer;
+};
+
+class ReplayReader {
+public:
+    // Reads the whole log. Throws std::runtime_error if it is missing, malformed or its config
+    // does not match its grid hash.
+    explicit ReplayReader(const std::string& path);
+
+    std::uint64_t getSeed() const { return seed; }
+    std::uint64_t getGridHash() const { return grid_hash; }
+    const json& getConfig() const { return config; }
+    std::size_t getNumAgents() const { return starts.size(); }
+    // Timesteps with recorded moves run from 0 to getNumSteps() - 1.
+    int getNumSteps() const { return static_cast<int>(steps.size()); }
+
+    // State at the start of timestep, fast-forwarded from the nearest keyframe before it. Throws
+    // std::out_of_range if the timestep was not recorded.
+    ReplayState stateAt(int timestep) const;
+
+private:
+    struct Hazard {
+        int timestep;
+        std::size_t event_index;
+    };
+    struct Keyframe {
+        int timestep;
+        std::size_t offset; // Of its positions in data
+    };
+
+    std::vector<std::uint8_t> data;
+    std::uint64_t seed = 0;
+    std::uint64_t grid_hash = 0;
+    json config;
+    std::vector<Position> starts;
+    std::vector<Hazard> hazards;
+    std::vector<Keyframe> keyframes;
+    std::vector<std::size_t> steps; // Offset of each timestep's moves in data
+
+    void readPositions(std::size_t offset, std::vector<Position>& positions) const;
+};
+
+#endif // ENMOD_REPLAY_LOG_H
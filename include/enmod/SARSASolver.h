@@ -5,14 +5,18 @@
 
 class SARSASolver : public RLSolver {
 public:
-    SARSASolver(const Grid& grid_ref);
+    SARSASolver(const Grid& grid_ref, const std::string& name = "SARSA");
     void run() override;
     Cost getEvacuationCost() const override;
+    std::unique_ptr<RLSolver> clone() const override;
     void generateReport(std::ofstream& report_file) const override;
     
     void train(int episodes) override;
     Direction chooseAction(const Position& state) override;
     void update(const Position& s, Direction a, double r, const Position& s_next, Direction a_next) override;
+    void chooseActionBatch(int lanes, const int* cells, int* actions) override;
+    void updateBatch(int lanes, const int* cells, const int* actions, const double* rewards,
+                     const int* next_cells, const int* next_actions) override;
 };
 
 #endif // ENMOD_SARSA_SOLVER_H
\ No newline at end of file
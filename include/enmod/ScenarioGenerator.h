@@ -2,6 +2,7 @@
 #define ENMOD_SCENARIO_GENERATOR_H
 
 #include "json.hpp"
+#include <cstdint>
 #include <string>
 
 using json = nlohmann::json;
@@ -9,6 +10,8 @@ using json = nlohmann::json;
 class ScenarioGenerator {
 public:
     static json generate(int size, const std::string& name);
+    // Same layout for the same seed, for benchmarks that must compare like with like across runs.
+    static json generate(int size, const std::string& name, std::uint32_t seed);
 };
 
 #endif // ENMOD_SCENARIO_GENERATOR_H
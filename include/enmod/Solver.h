@@ -2,6 +2,7 @@
     #define ENMOD_SOLVER_H
     
     #include "Grid.h"
+    #include <cstdint>
     #include <string>
     #include <vector>
     #include <fstream> 
@@ -14,6 +15,9 @@
         virtual void run() = 0;
         virtual Cost getEvacuationCost() const = 0;
         virtual void generateReport(std::ofstream& report_file) const = 0;
+        // Writes the run as a ReplayLog to path. Returns false if the solver keeps no turn-by-turn
+        // history to replay, as the static planners do.
+        virtual bool writeReplay(const std::string& /*path*/, std::uint64_t /*seed*/) const { return false; }
     
         const std::string& getName() const;
     
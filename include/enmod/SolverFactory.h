@@ -0,0 +1,18 @@
+#ifndef ENMOD_SOLVER_FACTORY_H
+#define ENMOD_SOLVER_FACTORY_H
+
+#include "Solver.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Creates solvers by name, so each comparison job can build its own instance on its own thread.
+class SolverFactory {
+public:
+    // Every solver in the comparison, in report order.
+    static const std::vector<std::string>& solverNames();
+    // Returns nullptr for an unknown name.
+    static std::unique_ptr<Solver> create(const std::string& name, const Grid& grid);
+};
+
+#endif // ENMOD_SOLVER_FACTORY_H
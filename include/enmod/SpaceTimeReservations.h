@@ -0,0 +1,45 @@
+#ifndef ENMOD_SPACE_TIME_RESERVATIONS_H
+#define ENMOD_SPACE_TIME_RESERVATIONS_H
+
+#include <cstdint>
+#include <vector>
+
+// Which agent holds each (cell, timestep) of a short planning window, timesteps counted from the
+// start of the current round. Open addressing over one flat array of 8-byte slots that is reused
+// from round to round: beginRound() empties only the slots the last round used, and the array
+// only ever grows, so a busy timestep allocates nothing and a probe rarely leaves its cache line.
+class SpaceTimeReservations {
+public:
+    static constexpr int MAX_WINDOW = 15; // Timesteps are packed into four bits of the key
+
+    // expected_entries sizes the table for the round so probes stay short.
+    void beginRound(std::size_t expected_entries);
+    // Later reservations of the same (cell, dt) replace earlier ones.
+    void reserve(int cell, int dt, int agent);
+    // The agent holding (cell, dt), or -1.
+    int owner(int cell, int dt) const {
+        std::uint32_t key = keyOf(cell, dt);
+        for (std::uint32_t i = home(key);; i = (i + 1) & mask) {
+            if (slots[i].key == key) return slots[i].agent;
+            if (slots[i].key == EMPTY) return -1;
+        }
+    }
+
+private:
+    static constexpr std::uint32_t EMPTY = 0xFFFFFFFFu;
+
+    struct Slot {
+        std::uint32_t key = EMPTY;
+        std::int32_t agent = -1;
+    };
+
+    std::vector<Slot> slots = std::vector<Slot>(64);
+    std::vector<std::uint32_t> used; // Slots filled this round
+    std::uint32_t mask = 63;
+    int shift = 26;                  // 32 - log2(slots.size())
+
+    static std::uint32_t keyOf(int cell, int dt) { return (static_cast<std::uint32_t>(cell) << 4) | static_cast<std::uint32_t>(dt); }
+    std::uint32_t home(std::uint32_t key) const { return (key * 0x9E3779B1u) >> shift; } // Fibonacci hashing
+};
+
+#endif // ENMOD_SPACE_TIME_RESERVATIONS_H
@@ -0,0 +1,50 @@
+#ifndef ENMOD_SPSC_QUEUE_H
+#define ENMOD_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread. The capacity
+// is rounded up to a power of two; head and tail only ever grow and are masked into the ring, and
+// they sit on separate cache lines so the two sides do not invalidate each other's line.
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(std::size_t capacity = 64) {
+        std::size_t size = 1;
+        while (size < capacity) size <<= 1;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    // Returns false, leaving the value untouched, when the queue is full.
+    bool tryPush(T&& value) {
+        std::size_t tail = tail_index.load(std::memory_order_relaxed);
+        if (tail - head_index.load(std::memory_order_acquire) == slots.size()) return false;
+        slots[tail & mask] = std::move(value);
+        tail_index.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Returns false when the queue is empty.
+    bool tryPop(T& value) {
+        std::size_t head = head_index.load(std::memory_order_relaxed);
+        if (head == tail_index.load(std::memory_order_acquire)) return false;
+        value = std::move(slots[head & mask]);
+        slots[head & mask] = T(); // Release whatever the message shares before the slot is reused
+        head_index.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t capacity() const { return slots.size(); }
+
+private:
+    std::vector<T> slots;
+    std::size_t mask = 0;
+    alignas(64) std::atomic<std::size_t> head_index{0}; // Next slot to pop; written by the consumer
+    alignas(64) std::atomic<std::size_t> tail_index{0}; // Next slot to push; written by the producer
+};
+
+#endif // ENMOD_SPSC_QUEUE_H
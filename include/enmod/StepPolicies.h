@@ -0,0 +1,50 @@
+#ifndef ENMOD_STEP_POLICIES_H
+#define ENMOD_STEP_POLICIES_H
+
+#include "DynamicSimulation.h"
+#include "FeatureQModel.h"
+#include <vector>
+
+// Greedy move down a cost-to-exit field: towards the walkable neighbour with the lowest cost, or
+// STAY when no neighbour improves on the current cell. Ties keep UP, DOWN, LEFT, RIGHT order.
+Direction descentDirection(const Grid& current_grid, const std::vector<std::vector<Cost>>& cost_map, const Position& current_pos);
+// descentDirection as a step decision, its action labelled with the given suffix.
+StepDecision descendCostMap(const Grid& current_grid, const std::vector<std::vector<Cost>>& cost_map,
+                            const Position& current_pos, const std::string& suffix = "");
+
+// Re-plans with BIDP on the current grid and takes the first step of the plan.
+class BIDPStepPolicy : public StepPolicy {
+public:
+    StepDecision decide(const Grid& current_grid, const Position& current_pos, EvacuationMode mode, int time_step) override;
+};
+
+// Re-plans with FIDP from the agent's position and takes the first step of the path.
+class FIDPStepPolicy : public StepPolicy {
+public:
+    StepDecision decide(const Grid& current_grid, const Position& current_pos, EvacuationMode mode, int time_step) override;
+};
+
+// Re-plans with value iteration (PolicyGenerator) and follows the resulting policy for one step.
+class AVIStepPolicy : public StepPolicy {
+public:
+    StepDecision decide(const Grid& current_grid, const Position& current_pos, EvacuationMode mode, int time_step) override;
+};
+
+// Re-plans with policy iteration (API) and follows the resulting policy for one step.
+class APIStepPolicy : public StepPolicy {
+public:
+    StepDecision decide(const Grid& current_grid, const Position& current_pos, EvacuationMode mode, int time_step) override;
+};
+
+// Follows a fixed LinearQModel on the features of the current grid: spreading hazards change what
+// the model sees, never its weights, so nothing is re-planned or retrained during the run.
+class FeatureQStepPolicy : public StepPolicy {
+public:
+    explicit FeatureQStepPolicy(const LinearQModel& model) : model(model) {}
+    StepDecision decide(const Grid& current_grid, const Position& current_pos, EvacuationMode mode, int time_step) override;
+
+private:
+    const LinearQModel& model;
+};
+
+#endif // ENMOD_STEP_POLICIES_H
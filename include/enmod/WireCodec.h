@@ -0,0 +1,75 @@
+#ifndef ENMOD_WIRE_CODEC_H
+#define ENMOD_WIRE_CODEC_H
+
+#include "AgentTransport.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Fixed-layout binary frames for CPS agent messages. All integers are little-endian and every field
+// sits at a fixed offset, so encoding and decoding are plain loads and stores with no parsing.
+//
+//   header       magic "EW" | version u8 | type u8 | payload length u32
+//   observation  agent id char[16] | timestep i32 | row i32 | col i32 | sequence u64 |
+//                flags u8 (1 = snapshot) | 3 pad | change count u32 | snapshot length u32 |
+//                changes (count x 12 bytes: kind u8 | fire size u8 | 2 pad | row i32 | col i32) |
+//                snapshot (scenario config as CBOR)
+//   command      agent id char[16] | timestep i32 | move u8 | flags u8 (1 = resync) | 2 pad
+//
+// Agent ids are at most 15 bytes, so decoding one stays within std::string's inline buffer.
+// Neither direction allocates, except for the snapshot, which is sent once per agent.
+enum class WireFrameType : std::uint8_t { OBSERVATION = 1, COMMAND = 2 };
+
+class WireCodec {
+public:
+    static constexpr std::uint8_t VERSION = 1;
+    static constexpr std::size_t HEADER_BYTES = 8;
+    static constexpr std::size_t MAX_AGENT_ID = 15;
+
+    // Encoders return the frame length, or 0 if the frame does not fit in capacity or the agent
+    // id is too long. An observation's length depends on its snapshot, so when it may carry one,
+    // appendObservation is the cheaper form: it grows out by exactly the frame (leaving it as it
+    // was on failure) instead of needing the capacity up front.
+    static std::size_t encodeObservation(const AgentObservation& observation, std::uint8_t* out, std::size_t capacity);
+    static std::size_t appendObservation(const AgentObservation& observation, std::vector<std::uint8_t>& out);
+    static std::size_t commandSize() { return HEADER_BYTES + 24; }
+    static std::size_t encodeCommand(const AgentCommand& command, std::uint8_t* out, std::size_t capacity);
+
+    // Length of the complete frame starting at data, or 0 if fewer than HEADER_BYTES are available
+    // or the header is not a frame of this version.
+    static std::size_t frameLength(const std::uint8_t* data, std::size_t size);
+    static WireFrameType frameType(const std::uint8_t* data) { return static_cast<WireFrameType>(data[3]); }
+
+    // Decoders overwrite out, reusing its storage, and return false on a malformed frame.
+    static bool decodeObservation(const std::uint8_t* data, std::size_t size, AgentObservation& out);
+    static bool decodeCommand(const std::uint8_t* data, std::size_t size, AgentCommand& out);
+};
+
+// Transport that carries every message as a binary frame through an in-memory byte stream, the
+// way it would cross a socket from a field device. Buffers keep their capacity between frames,
+// so steady-state traffic does not allocate. Not thread-safe: the controllers send and receive
+// on one thread.
+class WireTransport : public AgentTransport {
+public:
+    bool sendObservation(AgentObservation observation) override;
+    bool receiveObservation(AgentObservation& observation) override;
+    bool sendCommand(AgentCommand command) override;
+    bool receiveCommand(AgentCommand& command) override;
+    std::string getName() const override { return "wire"; }
+
+private:
+    struct ByteStream {
+        std::vector<std::uint8_t> bytes;
+        std::size_t read_offset = 0;
+
+        // Drops the frames already read if that is all of them, keeping the capacity.
+        void compact();
+        std::uint8_t* reserve(std::size_t length);
+        const std::uint8_t* nextFrame(std::size_t& length);
+    };
+
+    ByteStream uplink;
+    ByteStream downlink;
+};
+
+#endif // ENMOD_WIRE_CODEC_H
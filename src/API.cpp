@@ -1,5 +1,6 @@
 #include "enmod/API.h"
 #include "enmod/Logger.h"
+#include "enmod/Profiler.h"
 #include <vector>
 #include <algorithm>
 #include <fstream>
@@ -8,6 +9,7 @@ API::API(const Grid& grid_ref) : Solver(grid_ref, "API"), policy(grid_ref.getRow
 
 void API::run() {
     if (grid.getExitPositions().empty()) return;
+    ENMOD_PROFILE_PHASE(PHASE_PLANNING);
     auto first_exit = grid.getExitPositions()[0];
     for (int r = 0; r < grid.getRows(); ++r) {
         for (int c = 0; c < grid.getCols(); ++c) {
@@ -34,6 +36,7 @@ void API::run() {
             value_map[exit_pos.row][exit_pos.col] = {0, 0, 0};
         }
         
+        ENMOD_PROFILE_COUNT(COUNTER_SWEEPS, grid.getRows() * grid.getCols());
         for(int i = 0; i < grid.getRows() * grid.getCols(); ++i){
              for (int r = 0; r < grid.getRows(); ++r) {
                 for (int c = 0; c < grid.getCols(); ++c) {
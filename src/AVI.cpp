@@ -1,5 +1,6 @@
 #include "enmod/AVI.h"
 #include "enmod/Logger.h"
+#include "enmod/Profiler.h"
 #include <vector>
 #include <algorithm>
 #include <fstream>
@@ -11,7 +12,11 @@ const std::vector<std::vector<Cost>>& AVI::getCostMap() const {
 }
 
 void AVI::run() {
-    cost_map.assign(grid.getRows(), std::vector<Cost>(grid.getCols()));
+    {
+        ENMOD_PROFILE_PHASE(PHASE_PLANNER_SETUP);
+        cost_map.assign(grid.getRows(), std::vector<Cost>(grid.getCols()));
+    }
+    ENMOD_PROFILE_PHASE(PHASE_PLANNING);
 
     for (const auto& exit_pos : grid.getExitPositions()) {
         cost_map[exit_pos.row][exit_pos.col] = {0, 0, 0};
@@ -24,6 +29,7 @@ void AVI::run() {
     while (changed) {
         changed = false;
         iteration++;
+        ENMOD_PROFILE_COUNT(COUNTER_SWEEPS, 1);
         if (iteration > max_iterations) {
             Logger::log(LogLevel::ERROR, "AVI safety break triggered after " + std::to_string(max_iterations) + " iterations. Possible infinite loop.");
             break;
@@ -1,51 +1,151 @@
 #include "enmod/ActorCriticSolver.h"
-#include <random>
-#include <chrono>
+#include "enmod/Logger.h"
+#include <cmath>
 #include <algorithm>
 #include <vector>
-#include <numeric>
 
-ActorCriticSolver::ActorCriticSolver(const Grid& grid_ref) : RLSolver(grid_ref, "ActorCritic") {}
+ActorCriticSolver::ActorCriticSolver(const Grid& grid_ref, const std::string& name)
+    : RLSolver(grid_ref, name), state_value_table(static_cast<size_t>(grid_ref.getRows()) * grid_ref.getCols(), 0.0) {
+    // Zero preferences give every action equal probability initially
+    syncWithValueTable();
+}
 
 void ActorCriticSolver::run() {
-    train(10000); // Actor-Critic can take longer to converge
+    TrainingOptions options;
+    options.max_episodes = 10000; // Actor-Critic can take longer to converge
+    // A stable argmax is not enough on its own: it can settle long before it leads anywhere
+    options.require_greedy_exit = true;
+    TrainingSummary summary = runTraining(options);
     generatePolicyFromValueTable();
+    if (getEvacuationCost().distance == MAX_COST) {
+        Logger::log(LogLevel::WARN, solver_name + " on " + grid.getName() + ": learned policy reaches no exit after " +
+                                        std::to_string(summary.episodes) + " episodes.");
+    }
 }
 
-Direction ActorCriticSolver::chooseAction(const Position& state) {
-    static std::mt19937 rng(static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count()));
-    
-    if (value_table.find(state) == value_table.end()) {
-        value_table[state] = {1.0, 1.0, 1.0, 1.0}; // Equal probabilities initially
+void ActorCriticSolver::syncWithValueTable() {
+    action_cdf.resize(static_cast<size_t>(value_table.numCells()) * NUM_ACTIONS);
+    for (int cell = 0; cell < value_table.numCells(); ++cell) refreshActionCdf(cell);
+}
+
+void ActorCriticSolver::refreshActionCdf(int cell) {
+    // Softmax over the preferences, shifted by the maximum so exp() cannot overflow
+    const QValue* prefs = value_table.values(cell);
+    double max_pref = value_table.maxValue(cell);
+    double weights[NUM_ACTIONS];
+    double total = 0.0;
+    for (int a = 0; a < NUM_ACTIONS; ++a) {
+        weights[a] = std::exp(static_cast<double>(prefs[a]) - max_pref);
+        total += weights[a];
+    }
+    double* cdf = &action_cdf[static_cast<size_t>(cell) * NUM_ACTIONS];
+    double cumulative = 0.0;
+    for (int a = 0; a < NUM_ACTIONS - 1; ++a) {
+        cumulative += weights[a] / total;
+        cdf[a] = cumulative;
     }
-    
-    // Choose action based on the probabilities in the actor's table
-    std::discrete_distribution<> dist(value_table.at(state).begin(), value_table.at(state).end());
-    return static_cast<Direction>(dist(rng));
+    cdf[NUM_ACTIONS - 1] = 1.0;
+}
+
+double ActorCriticSolver::actionProbability(int cell, int action) const {
+    const double* cdf = &action_cdf[static_cast<size_t>(cell) * NUM_ACTIONS];
+    return action == 0 ? cdf[0] : cdf[action] - cdf[action - 1];
+}
+
+int ActorCriticSolver::sampleAction(int cell) {
+    const double* cdf = &action_cdf[static_cast<size_t>(cell) * NUM_ACTIONS];
+    double u = rng.uniform();
+    int action = 0;
+    for (int a = 0; a < NUM_ACTIONS - 1; ++a) action += u >= cdf[a] ? 1 : 0;
+    return action;
+}
+
+Direction ActorCriticSolver::chooseAction(const Position& state) {
+    int cell = value_table.cellIndex(state);
+    value_table.markVisited(cell);
+    return static_cast<Direction>(sampleAction(cell));
 }
 
 void ActorCriticSolver::update(const Position& s, Direction a, double r, const Position& s_next, Direction /*a_next*/) {
-    double actor_alpha = 0.01; // Actor often needs a smaller learning rate
+    learn(value_table.cellIndex(s), static_cast<int>(a), r, value_table.cellIndex(s_next));
+}
 
+void ActorCriticSolver::learn(int cell, int action, double reward, int next_cell) {
     // --- Critic Update ---
-    double old_state_value = state_value_table.count(s) ? state_value_table[s] : 0.0;
-    double next_state_value = state_value_table.count(s_next) ? state_value_table[s_next] : 0.0;
-    
-    // Calculate the TD Error
-    double td_error = r + gamma * next_state_value - old_state_value;
-    
-    // Update the Critic's value for the current state
-    state_value_table[s] = old_state_value + alpha * td_error;
+    double td_error = reward + gamma * state_value_table[next_cell] - state_value_table[cell];
+    state_value_table[cell] += alpha * td_error;
 
     // --- Actor Update ---
-    if (value_table.find(s) == value_table.end()) {
-        value_table[s] = {1.0, 1.0, 1.0, 1.0};
+    // Softmax policy gradient: d log pi(a|s) / d theta(s,b) = 1[b == a] - pi(b|s), plus the gradient
+    // of the policy's entropy H: dH / d theta(s,b) = -pi(b|s) * (log pi(b|s) + H)
+    value_table.markVisited(cell);
+    QValue* prefs = value_table.values(cell);
+    double probabilities[NUM_ACTIONS];
+    double entropy = 0.0;
+    for (int b = 0; b < NUM_ACTIONS; ++b) {
+        probabilities[b] = actionProbability(cell, b);
+        if (probabilities[b] > 0.0) entropy -= probabilities[b] * std::log(probabilities[b]);
+    }
+    for (int b = 0; b < NUM_ACTIONS; ++b) {
+        double indicator = b == action ? 1.0 : 0.0;
+        double log_probability = probabilities[b] > 0.0 ? std::log(probabilities[b]) : 0.0;
+        double policy_step = ACTOR_ALPHA * td_error * (indicator - probabilities[b]);
+        double entropy_step = -ENTROPY_WEIGHT * probabilities[b] * (log_probability + entropy);
+        prefs[b] = static_cast<QValue>(prefs[b] + policy_step + entropy_step);
+    }
+    refreshActionCdf(cell);
+}
+
+void ActorCriticSolver::chooseActionBatch(int lanes, const int* cells, int* actions) {
+    for (int i = 0; i < lanes; ++i) {
+        value_table.markVisited(cells[i]);
+        actions[i] = sampleAction(cells[i]);
+    }
+}
+
+void ActorCriticSolver::updateBatch(int lanes, const int* cells, const int* actions, const double* rewards,
+                                    const int* next_cells, const int* /*next_actions*/) {
+    for (int i = 0; i < lanes; ++i) learn(cells[i], actions[i], rewards[i], next_cells[i]);
+}
+
+void ActorCriticSolver::initializeFromCostMap(const std::vector<std::vector<Cost>>& cost_map) {
+    RLSolver::initializeFromCostMap(cost_map);
+    std::vector<double> values = stateValuesFromCostMap(cost_map);
+
+    for (int cell = 0; cell < value_table.numCells(); ++cell) {
+        if (!value_table.isVisited(cell)) continue;
+        state_value_table[cell] = values[cell];
+
+        // Map the seeded action values onto preferences in [-SEED_PREFERENCE_RANGE, 0], so the
+        // DP-greedy action dominates the softmax while every action keeps some probability.
+        QValue* prefs = value_table.values(cell);
+        QValue q_min = *std::min_element(prefs, prefs + NUM_ACTIONS);
+        QValue q_max = *std::max_element(prefs, prefs + NUM_ACTIONS);
+        for (int a = 0; a < NUM_ACTIONS; ++a) {
+            prefs[a] = static_cast<QValue>(q_max > q_min ? SEED_PREFERENCE_RANGE * (prefs[a] - q_max) / (q_max - q_min) : 0.0);
+        }
+    }
+    syncWithValueTable();
+}
+
+std::unique_ptr<RLSolver> ActorCriticSolver::clone() const {
+    return std::make_unique<ActorCriticSolver>(*this);
+}
+
+double ActorCriticSolver::mergeWorkers(const std::vector<const RLSolver*>& workers) {
+    // Workers are clones of this solver, so the downcast is safe
+    for (size_t cell = 0; cell < state_value_table.size(); ++cell) {
+        double sum = 0.0;
+        int contributors = 0;
+        for (const RLSolver* worker : workers) {
+            const auto* critic = static_cast<const ActorCriticSolver*>(worker);
+            if (!critic->value_table.isVisited(static_cast<int>(cell))) continue;
+            sum += critic->state_value_table[cell];
+            ++contributors;
+        }
+        if (contributors > 0) state_value_table[cell] = sum / contributors;
     }
-    // Update the probability of taking that action based on the Critic's feedback (TD Error)
-    int action_idx = static_cast<int>(a);
-    value_table[s][action_idx] += actor_alpha * td_error;
-    // Ensure probabilities don't go below a small value
-    if(value_table[s][action_idx] < 0.01) value_table[s][action_idx] = 0.01;
+    return RLSolver::mergeWorkers(workers);
 }
 
 Cost ActorCriticSolver::getEvacuationCost() const {
@@ -66,7 +166,7 @@ Cost ActorCriticSolver::getEvacuationCost() const {
 
 void ActorCriticSolver::generateReport(std::ofstream& report_file) const {
     report_file << "<h2>Final Learned Policy (Actor-Critic)</h2>\n";
-    report_file << "<p>This policy was learned over 10000 episodes.</p>\n";
+    writeTrainingSummary(report_file);
     report_file << grid.toHtmlStringWithPolicy(policy);
 }
 
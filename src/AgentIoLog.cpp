@@ -0,0 +1,148 @@
+#include "enmod/AgentIoLog.h"
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+void putU64(std::uint8_t* out, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+}
+
+std::uint64_t getU64(const std::uint8_t* in) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+    return value;
+}
+
+int getI32(const std::uint8_t* in) {
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) value |= static_cast<std::uint32_t>(in[i]) << (8 * i);
+    return static_cast<int>(value);
+}
+
+// Both frame types start with agent id char[16] | timestep i32 right after the header.
+std::string frameAgentId(const std::uint8_t* frame) {
+    const char* id = reinterpret_cast<const char*>(frame + WireCodec::HEADER_BYTES);
+    return std::string(id, strnlen(id, 16));
+}
+
+int frameTimestep(const std::uint8_t* frame) { return getI32(frame + WireCodec::HEADER_BYTES + 16); }
+
+bool readFrameAt(std::istream& in, std::uint64_t offset, std::vector<std::uint8_t>& frame) {
+    frame.resize(WireCodec::HEADER_BYTES);
+    in.clear();
+    in.seekg(static_cast<std::streamoff>(offset));
+    if (!in.read(reinterpret_cast<char*>(frame.data()), WireCodec::HEADER_BYTES)) return false;
+    std::size_t length = WireCodec::frameLength(frame.data(), frame.size());
+    if (length == 0) return false;
+    frame.resize(length);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(frame.data()) + WireCodec::HEADER_BYTES, length - WireCodec::HEADER_BYTES));
+}
+
+} // namespace
+
+AgentIoLog::AgentIoLog(const std::string& directory) {
+    std::string log_path = directory + "/" + LOG_FILE;
+    log.open(log_path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    index.open(directory + "/" + INDEX_FILE, std::ios::binary | std::ios::trunc);
+    if (!log || !index) throw std::runtime_error("Could not create the agent I/O log in " + directory);
+    const char header[FILE_HEADER_BYTES] = {'E', 'I', 'O', 'L', static_cast<char>(VERSION), 0, 0, 0};
+    log.write(header, sizeof(header));
+    pending.reserve(FLUSH_BYTES);
+}
+
+AgentIoLog::~AgentIoLog() { flush(); }
+
+std::uint64_t AgentIoLog::append(const std::uint8_t* frame, std::size_t length) {
+    std::uint64_t offset = pending_offset + pending.size();
+    pending.insert(pending.end(), frame, frame + length);
+
+    std::uint8_t entry[INDEX_ENTRY_BYTES] = {};
+    std::memcpy(entry, frame + WireCodec::HEADER_BYTES, 20); // Agent id and timestep, as in the frame
+    entry[20] = static_cast<std::uint8_t>(WireCodec::frameType(frame));
+    putU64(entry + 24, offset);
+    pending_index.insert(pending_index.end(), entry, entry + INDEX_ENTRY_BYTES);
+
+    if (pending.size() >= FLUSH_BYTES) flush();
+    return offset;
+}
+
+bool AgentIoLog::read(std::uint64_t offset, std::vector<std::uint8_t>& frame) {
+    if (offset >= pending_offset) { // Still in memory
+        std::size_t start = static_cast<std::size_t>(offset - pending_offset);
+        if (start >= pending.size()) return false;
+        std::size_t length = WireCodec::frameLength(pending.data() + start, pending.size() - start);
+        if (length == 0) return false;
+        frame.assign(pending.begin() + start, pending.begin() + start + length);
+        return true;
+    }
+    return readFrameAt(log, offset, frame);
+}
+
+void AgentIoLog::flush() {
+    if (pending.empty()) return;
+    log.clear();
+    log.seekp(0, std::ios::end);
+    log.write(reinterpret_cast<const char*>(pending.data()), static_cast<std::streamsize>(pending.size()));
+    log.flush();
+    index.write(reinterpret_cast<const char*>(pending_index.data()), static_cast<std::streamsize>(pending_index.size()));
+    index.flush();
+    pending_offset += pending.size();
+    pending.clear();
+    pending_index.clear();
+}
+
+AgentIoLogReader::AgentIoLogReader(const std::string& directory) : log(directory + "/" + AgentIoLog::LOG_FILE, std::ios::binary) {
+    char header[AgentIoLog::FILE_HEADER_BYTES];
+    if (!log.read(header, sizeof(header)) || std::memcmp(header, "EIOL", 4) != 0 || header[4] != static_cast<char>(AgentIoLog::VERSION)) {
+        throw std::runtime_error("No agent I/O log in " + directory);
+    }
+
+    std::uint64_t next = AgentIoLog::FILE_HEADER_BYTES; // End of the last frame the index covers
+    std::ifstream index(directory + "/" + AgentIoLog::INDEX_FILE, std::ios::binary);
+    std::uint8_t entry[AgentIoLog::INDEX_ENTRY_BYTES];
+    std::uint64_t last = 0;
+    while (index.read(reinterpret_cast<char*>(entry), sizeof(entry))) {
+        const char* id = reinterpret_cast<const char*>(entry);
+        last = getU64(entry + 24);
+        offsets[{std::string(id, strnlen(id, 16)), getI32(entry + 16), entry[20]}] = last;
+        ++num_messages;
+    }
+    if (num_messages > 0 && readFrame(last)) next = last + frame.size();
+
+    while (readFrame(next)) {
+        offsets[{frameAgentId(frame.data()), frameTimestep(frame.data()), static_cast<std::uint8_t>(WireCodec::frameType(frame.data()))}] = next;
+        ++num_messages;
+        next += frame.size();
+    }
+}
+
+bool AgentIoLogReader::readFrame(std::uint64_t offset) {
+    return readFrameAt(log, offset, frame);
+}
+
+const std::uint64_t* AgentIoLogReader::find(const std::string& agent_id, int timestep, WireFrameType type) const {
+    auto it = offsets.find({agent_id, timestep, static_cast<std::uint8_t>(type)});
+    return it == offsets.end() ? nullptr : &it->second;
+}
+
+std::vector<int> AgentIoLogReader::getTimesteps(const std::string& agent_id) const {
+    std::vector<int> timesteps;
+    for (auto it = offsets.lower_bound({agent_id, std::numeric_limits<int>::min(), 0});
+         it != offsets.end() && std::get<0>(it->first) == agent_id; ++it) {
+        int timestep = std::get<1>(it->first);
+        if (timesteps.empty() || timesteps.back() != timestep) timesteps.push_back(timestep);
+    }
+    return timesteps;
+}
+
+bool AgentIoLogReader::readObservation(const std::string& agent_id, int timestep, AgentObservation& observation) {
+    const std::uint64_t* offset = find(agent_id, timestep, WireFrameType::OBSERVATION);
+    return offset && readFrame(*offset) && WireCodec::decodeObservation(frame.data(), frame.size(), observation);
+}
+
+bool AgentIoLogReader::readCommand(const std::string& agent_id, int timestep, AgentCommand& command) {
+    const std::uint64_t* offset = find(agent_id, timestep, WireFrameType::COMMAND);
+    return offset && readFrame(*offset) && WireCodec::decodeCommand(frame.data(), frame.size(), command);
+}
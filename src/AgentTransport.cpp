@@ -0,0 +1,158 @@
+#include "enmod/AgentTransport.h"
+#include "enmod/AgentIoLog.h"
+#include "enmod/DynamicSimulation.h"
+#include "enmod/WireCodec.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+
+Direction parseMove(const std::string& move) {
+    if (move == "UP") return Direction::UP;
+    if (move == "DOWN") return Direction::DOWN;
+    if (move == "LEFT") return Direction::LEFT;
+    if (move == "RIGHT") return Direction::RIGHT;
+    return Direction::STAY;
+}
+
+} // namespace
+
+std::unique_ptr<AgentTransport> AgentTransport::fromEnvironment(const std::string& directory, FileLayout layout) {
+    const char* kind = std::getenv("ENMOD_AGENT_TRANSPORT");
+    if (kind && std::string(kind) == "file") {
+        if (const char* files = std::getenv("ENMOD_AGENT_FILES")) {
+            std::string name = files;
+            if (name == "shared") layout = FileLayout::SHARED;
+            else if (name == "per-message") layout = FileLayout::PER_MESSAGE;
+            else if (name == "log") layout = FileLayout::LOG;
+        }
+        return std::make_unique<FileTransport>(directory, layout);
+    }
+    if (kind && std::string(kind) == "wire") return std::make_unique<WireTransport>();
+    return std::make_unique<InProcessTransport>();
+}
+
+InProcessTransport::InProcessTransport(std::size_t capacity) : uplink(capacity), downlink(capacity) {}
+
+bool InProcessTransport::sendObservation(AgentObservation observation) {
+    return uplink.tryPush(std::move(observation));
+}
+
+bool InProcessTransport::receiveObservation(AgentObservation& observation) {
+    return uplink.tryPop(observation);
+}
+
+bool InProcessTransport::sendCommand(AgentCommand command) {
+    return downlink.tryPush(std::move(command));
+}
+
+bool InProcessTransport::receiveCommand(AgentCommand& command) {
+    return downlink.tryPop(command);
+}
+
+FileTransport::FileTransport(const std::string& directory, FileLayout layout)
+    : directory(directory), layout(layout) {
+    std::filesystem::create_directories(directory);
+    if (layout == FileLayout::LOG) log = std::make_unique<AgentIoLog>(directory);
+}
+
+FileTransport::~FileTransport() = default;
+
+std::string FileTransport::messagePath(const std::string& agent_id, int timestep, const std::string& direction) const {
+    if (layout != FileLayout::PER_MESSAGE) return directory + "/agent_" + direction + ".json";
+    return directory + "/" + agent_id + "_" + direction + "_t" + std::to_string(timestep) + ".json";
+}
+
+void FileTransport::queue(std::deque<std::string>& pending, const std::string& path) const {
+    if (layout == FileLayout::SHARED) pending.clear();
+    pending.push_back(path);
+}
+
+bool FileTransport::sendObservation(AgentObservation observation) {
+    if (log) {
+        frame.clear();
+        if (WireCodec::appendObservation(observation, frame) == 0) return false;
+        pending_input_frames.push_back(log->append(frame.data(), frame.size()));
+        return true;
+    }
+    json input_data;
+    input_data["agent_id"] = observation.agent_id;
+    input_data["timestep"] = observation.timestep;
+    input_data["current_position"] = {
+        {"row", observation.position.row},
+        {"col", observation.position.col}
+    };
+    input_data["environment_update"] = observation.environment.toJson();
+
+    std::string path = messagePath(observation.agent_id, observation.timestep, "input");
+    std::ofstream o(path);
+    if (!o) return false;
+    o << std::setw(4) << input_data << std::endl;
+    queue(pending_inputs, path);
+    return true;
+}
+
+bool FileTransport::receiveObservation(AgentObservation& observation) {
+    if (log) {
+        if (pending_input_frames.empty()) return false;
+        std::uint64_t offset = pending_input_frames.front();
+        pending_input_frames.pop_front();
+        return log->read(offset, frame) && WireCodec::decodeObservation(frame.data(), frame.size(), observation);
+    }
+    if (pending_inputs.empty()) return false;
+    std::ifstream i(pending_inputs.front());
+    pending_inputs.pop_front();
+    if (!i) return false;
+    json received_data;
+    i >> received_data;
+
+    observation.agent_id = received_data.at("agent_id");
+    observation.timestep = received_data.at("timestep");
+    observation.position = {received_data.at("current_position").at("row"), received_data.at("current_position").at("col")};
+    observation.environment = EnvironmentUpdate::fromJson(received_data.at("environment_update"));
+    return true;
+}
+
+bool FileTransport::sendCommand(AgentCommand command) {
+    if (log) {
+        frame.resize(WireCodec::commandSize());
+        if (WireCodec::encodeCommand(command, frame.data(), frame.size()) != frame.size()) return false;
+        pending_output_frames.push_back(log->append(frame.data(), frame.size()));
+        return true;
+    }
+    json output_data;
+    output_data["agent_id"] = command.agent_id;
+    output_data["timestep"] = command.timestep;
+    output_data["next_move"] = actionName(command.move);
+    if (command.resync) output_data["resync"] = true;
+
+    std::string path = messagePath(command.agent_id, command.timestep, "output");
+    std::ofstream o(path);
+    if (!o) return false;
+    o << std::setw(4) << output_data << std::endl;
+    queue(pending_outputs, path);
+    return true;
+}
+
+bool FileTransport::receiveCommand(AgentCommand& command) {
+    if (log) {
+        if (pending_output_frames.empty()) return false;
+        std::uint64_t offset = pending_output_frames.front();
+        pending_output_frames.pop_front();
+        return log->read(offset, frame) && WireCodec::decodeCommand(frame.data(), frame.size(), command);
+    }
+    if (pending_outputs.empty()) return false;
+    std::ifstream i(pending_outputs.front());
+    pending_outputs.pop_front();
+    if (!i) return false;
+    json output_data;
+    i >> output_data;
+
+    command.agent_id = output_data.at("agent_id");
+    command.timestep = output_data.value("timestep", 0);
+    command.move = parseMove(output_data.at("next_move"));
+    command.resync = output_data.value("resync", false);
+    return true;
+}
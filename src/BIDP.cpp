@@ -1,19 +1,28 @@
 #include "enmod/BIDP.h"
 #include "enmod/HtmlReportGenerator.h"
+#include "enmod/Profiler.h"
 #include <queue>
 #include <vector>
 #include <algorithm>
 
 BIDP::BIDP(const Grid& grid_ref) : Solver(grid_ref, "BIDP") {}
 
+BIDP::BIDP(const Grid& grid_ref, std::vector<Position> target_exits)
+    : Solver(grid_ref, "BIDP"), target_exits(std::move(target_exits)) {}
+
 void BIDP::run() {
-    cost_map.assign(grid.getRows(), std::vector<Cost>(grid.getCols()));
+    {
+        ENMOD_PROFILE_PHASE(PHASE_PLANNER_SETUP);
+        cost_map.assign(grid.getRows(), std::vector<Cost>(grid.getCols()));
+    }
+    ENMOD_PROFILE_PHASE(PHASE_PLANNING);
 
     std::priority_queue<std::pair<Cost, Position>, std::vector<std::pair<Cost, Position>>, std::greater<std::pair<Cost, Position>>> pq;
 
-    for (const auto& exit_pos : grid.getExitPositions()) {
+    for (const auto& exit_pos : target_exits.empty() ? grid.getExitPositions() : target_exits) {
         cost_map[exit_pos.row][exit_pos.col] = {0, 0, 0};
         pq.push({{0, 0, 0}, exit_pos});
+        ENMOD_PROFILE_COUNT(COUNTER_HEAP_PUSHES, 1);
     }
 
     int dr[] = {-1, 1, 0, 0};
@@ -22,6 +31,7 @@ void BIDP::run() {
     while (!pq.empty()) {
         auto [current_cost, current_pos] = pq.top();
         pq.pop();
+        ENMOD_PROFILE_COUNT(COUNTER_HEAP_POPS, 1);
 
         if (cost_map[current_pos.row][current_pos.col] < current_cost) {
             continue;
@@ -39,6 +49,8 @@ void BIDP::run() {
                 if (new_cost < cost_map[next_pos.row][next_pos.col]) {
                     cost_map[next_pos.row][next_pos.col] = new_cost;
                     pq.push({new_cost, next_pos});
+                    ENMOD_PROFILE_COUNT(COUNTER_HEAP_PUSHES, 1);
+                    ENMOD_PROFILE_COUNT(COUNTER_RELAXATIONS, 1);
                 }
             }
         }
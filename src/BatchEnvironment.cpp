@@ -0,0 +1,44 @@
+#include "enmod/BatchEnvironment.h"
+
+BatchEnvironment::BatchEnvironment(const Grid& grid) : cols(grid.getCols()) {
+    int cells = grid.getRows() * grid.getCols();
+    next_cells.resize(static_cast<size_t>(cells) * NUM_ACTIONS);
+    rewards.resize(static_cast<size_t>(cells) * NUM_ACTIONS);
+    terminal.assign(cells, 0);
+    start_cell = cellIndex(grid.getStartPosition());
+
+    for (int cell = 0; cell < cells; ++cell) {
+        Position pos = cellPosition(cell);
+        terminal[cell] = grid.isExit(pos.row, pos.col) ? 1 : 0;
+        for (int a = 0; a < NUM_ACTIONS; ++a) {
+            Position next = grid.getNextPosition(pos, static_cast<Direction>(a));
+            rewards[cell * NUM_ACTIONS + a] = transitionReward(grid, pos, next);
+            next_cells[cell * NUM_ACTIONS + a] = cellIndex(next);
+        }
+    }
+}
+
+double BatchEnvironment::transitionReward(const Grid& grid, const Position& current, Position& next) {
+    if (!grid.isWalkable(next.row, next.col)) {
+        next = current;
+        return -100;
+    }
+    if (grid.isExit(next.row, next.col)) return 1000;
+    CellType type = grid.getCellType(next);
+    if (type == CellType::FIRE) return -200;
+    if (type == CellType::SMOKE) return -20;
+    return -1;
+}
+
+void BatchEnvironment::step(int lanes, const int* cells, const int* actions, int* out_cells, double* out_rewards, unsigned char* out_done) const {
+    const int* next_table = next_cells.data();
+    const double* reward_table = rewards.data();
+    const unsigned char* terminal_table = terminal.data();
+    for (int i = 0; i < lanes; ++i) {
+        int idx = cells[i] * NUM_ACTIONS + actions[i];
+        int next = next_table[idx];
+        out_cells[i] = next;
+        out_rewards[i] = reward_table[idx];
+        out_done[i] = terminal_table[next];
+    }
+}
@@ -0,0 +1,208 @@
+#include "enmod/Benchmark.h"
+#include "enmod/SolverFactory.h"
+#include "enmod/ScenarioGenerator.h"
+#include "enmod/QLearningSolver.h"
+#include "enmod/RLSolver.h"
+#include "enmod/SARSASolver.h"
+#include "enmod/Random.h"
+#include "enmod/Logger.h"
+#include "enmod/MultiAgentCPSController.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+
+SampleStats SampleStats::of(std::vector<double> samples) {
+    SampleStats stats;
+    stats.count = static_cast<int>(samples.size());
+    if (samples.empty()) return stats;
+    std::sort(samples.begin(), samples.end());
+
+    auto percentile = [&](double p) {
+        double rank = p * (samples.size() - 1);
+        std::size_t lower = static_cast<std::size_t>(rank);
+        std::size_t upper = std::min(lower + 1, samples.size() - 1);
+        return samples[lower] + (rank - lower) * (samples[upper] - samples[lower]);
+    };
+
+    double sum = 0.0;
+    for (double sample : samples) sum += sample;
+    stats.mean = sum / samples.size();
+    double squares = 0.0;
+    for (double sample : samples) squares += (sample - stats.mean) * (sample - stats.mean);
+    stats.stddev = samples.size() > 1 ? std::sqrt(squares / (samples.size() - 1)) : 0.0;
+    stats.min = samples.front();
+    stats.median = percentile(0.50);
+    stats.p95 = percentile(0.95);
+    stats.p99 = percentile(0.99);
+    stats.max = samples.back();
+    return stats;
+}
+
+BenchmarkRunner::BenchmarkRunner(const BenchmarkOptions& options) : options(options) {
+    const auto& known = SolverFactory::solverNames();
+    if (this->options.solvers.empty()) this->options.solvers = known;
+    for (const auto& name : this->options.solvers) {
+        if (std::find(known.begin(), known.end(), name) == known.end()) throw std::invalid_argument("Unknown solver: " + name);
+    }
+    std::sort(this->options.grid_sizes.begin(), this->options.grid_sizes.end());
+}
+
+std::vector<BenchmarkRecord> BenchmarkRunner::run() {
+    std::vector<BenchmarkRecord> records;
+    std::set<std::string> over_budget;
+    std::uint64_t saved_seed = RLSolver::run_seed;
+
+    for (int size : options.grid_sizes) {
+        // One layout per size, shared by every solver and repetition, so the spread is the solver's own
+        Grid grid(ScenarioGenerator::generate(size, std::to_string(size) + "x" + std::to_string(size),
+                                              static_cast<std::uint32_t>(deriveSeed(options.seed, "grid" + std::to_string(size)))));
+        std::cout << "\n===== Benchmark grid " << size << "x" << size << " =====\n";
+
+        for (const auto& name : options.solvers) {
+            if (over_budget.count(name)) continue;
+
+            BenchmarkRecord record;
+            record.solver = name;
+            record.grid_size = size;
+            record.repetitions = options.repetitions;
+            std::vector<double> runtimes, costs;
+            for (int rep = -options.warmup; rep < options.repetitions; ++rep) {
+                // RL solvers draw a fresh stream per repetition; warm-up runs reuse the first ones
+                RLSolver::run_seed = deriveSeed(options.seed, name + "#" + std::to_string(std::max(rep, 0)));
+                Cost::current_mode = EvacuationMode::NORMAL;
+                auto solver = SolverFactory::create(name, grid);
+                if (options.trace_decay > 0.0) {
+                    // Actor-Critic has no trace variant
+                    RLSolver* rl_solver = dynamic_cast<QLearningSolver*>(solver.get());
+                    if (!rl_solver) rl_solver = dynamic_cast<SARSASolver*>(solver.get());
+                    if (rl_solver) rl_solver->setTraceDecay(options.trace_decay);
+                }
+                if (options.batch_lanes > 0) {
+                    if (auto* rl_solver = dynamic_cast<RLSolver*>(solver.get())) rl_solver->setBatchLanes(options.batch_lanes);
+                }
+                if (options.train_workers > 1) {
+                    if (auto* rl_solver = dynamic_cast<RLSolver*>(solver.get())) rl_solver->setTrainingWorkers(options.train_workers);
+                }
+                auto start_time = std::chrono::steady_clock::now();
+                solver->run();
+                std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start_time;
+                if (rep < 0) continue;
+
+                runtimes.push_back(elapsed.count());
+                Cost cost = solver->getEvacuationCost();
+                if (cost.distance == MAX_COST) ++record.failures;
+                else costs.push_back(weightedCost(cost));
+            }
+            record.runtime_ms = SampleStats::of(runtimes);
+            record.weighted_cost = SampleStats::of(costs);
+            records.push_back(record);
+
+            std::cout << "  - " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(3)
+                      << " median " << record.runtime_ms.median << " ms, p95 " << record.runtime_ms.p95
+                      << " ms, stddev " << record.runtime_ms.stddev << " ms, failures " << record.failures << "/" << record.repetitions << "\n";
+            if (record.runtime_ms.median > options.time_budget_ms) {
+                over_budget.insert(name);
+                Logger::log(LogLevel::INFO, "Benchmark: " + name + " exceeded the time budget at " + std::to_string(size) +
+                            "x" + std::to_string(size) + "; skipping larger grids.");
+            }
+        }
+    }
+    RLSolver::run_seed = saved_seed;
+    return records;
+}
+
+void BenchmarkRunner::writeCsv(const std::vector<BenchmarkRecord>& records, const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        Logger::log(LogLevel::ERROR, "Could not write benchmark CSV " + path);
+        return;
+    }
+    auto write_stats = [&](const SampleStats& s) {
+        out << "," << s.count << "," << s.mean << "," << s.stddev << "," << s.min << "," << s.median << "," << s.p95 << "," << s.p99 << "," << s.max;
+    };
+    out << "solver,grid_size,repetitions,failures";
+    for (const char* series : {"runtime_ms", "weighted_cost"}) {
+        for (const char* field : {"count", "mean", "stddev", "min", "median", "p95", "p99", "max"}) out << "," << series << "_" << field;
+    }
+    out << "\n" << std::setprecision(6);
+    for (const auto& record : records) {
+        out << record.solver << "," << record.grid_size << "," << record.repetitions << "," << record.failures;
+        write_stats(record.runtime_ms);
+        write_stats(record.weighted_cost);
+        out << "\n";
+    }
+}
+
+void BenchmarkRunner::writeJson(const std::vector<BenchmarkRecord>& records, const BenchmarkOptions& options, const std::string& path) {
+    auto to_json = [](const SampleStats& s) {
+        return json{{"count", s.count}, {"mean", s.mean}, {"stddev", s.stddev}, {"min", s.min},
+                    {"median", s.median}, {"p95", s.p95}, {"p99", s.p99}, {"max", s.max}};
+    };
+    json doc;
+    doc["options"] = {{"warmup", options.warmup}, {"repetitions", options.repetitions}, {"seed", options.seed},
+                      {"grid_sizes", options.grid_sizes}, {"time_budget_ms", options.time_budget_ms},
+                      {"trace_decay", options.trace_decay}, {"batch_lanes", options.batch_lanes},
+                      {"train_workers", options.train_workers}};
+    doc["results"] = json::array();
+    for (const auto& record : records) {
+        doc["results"].push_back({{"solver", record.solver}, {"grid_size", record.grid_size},
+                                  {"repetitions", record.repetitions}, {"failures", record.failures},
+                                  {"runtime_ms", to_json(record.runtime_ms)}, {"weighted_cost", to_json(record.weighted_cost)}});
+    }
+    std::ofstream out(path);
+    if (!out) {
+        Logger::log(LogLevel::ERROR, "Could not write benchmark JSON " + path);
+        return;
+    }
+    out << doc.dump(2) << "\n";
+}
+
+std::vector<AgentScalingRecord> AgentScalingBenchmark::run(const std::string& work_dir) {
+    std::string name = std::to_string(options.grid_size) + "x" + std::to_string(options.grid_size);
+    json config = ScenarioGenerator::generate(options.grid_size, name, static_cast<std::uint32_t>(deriveSeed(options.seed, "agents" + name)));
+    std::cout << "\n===== Multi-agent scaling on " << name << " =====\n";
+
+    std::vector<AgentScalingRecord> records;
+    for (int count : options.agent_counts) {
+        std::string dir = work_dir + "/agents_" + std::to_string(count);
+        std::filesystem::create_directories(dir);
+        MultiAgentCPSController controller(config, dir, count, options.workers);
+        for (int t = 0; t < options.timesteps && !controller.step(t); ++t) {}
+
+        const MultiAgentStats& stats = controller.getStats();
+        AgentScalingRecord record;
+        record.agents = static_cast<int>(controller.getNumAgents());
+        record.workers = controller.getNumWorkers();
+        record.timesteps = stats.timesteps;
+        record.decisions = stats.decisions;
+        record.decision_ms = stats.decision_ms;
+        record.exchange_ms = stats.exchange_ms;
+        if (stats.decision_ms > 0) record.decisions_per_second = stats.decisions * 1000.0 / stats.decision_ms;
+        if (stats.decision_ms + stats.exchange_ms > 0) record.end_to_end_per_second = stats.decisions * 1000.0 / (stats.decision_ms + stats.exchange_ms);
+        records.push_back(record);
+
+        std::cout << "  - " << std::setw(6) << record.agents << " agents, " << record.workers << " workers: " << std::fixed << std::setprecision(0)
+                  << record.decisions_per_second << " decisions/s planning, " << record.end_to_end_per_second << " decisions/s end to end over "
+                  << record.timesteps << " steps\n";
+    }
+    return records;
+}
+
+void AgentScalingBenchmark::writeCsv(const std::vector<AgentScalingRecord>& records, const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        Logger::log(LogLevel::ERROR, "Could not write agent scaling CSV " + path);
+        return;
+    }
+    out << "agents,workers,timesteps,decisions,decision_ms,exchange_ms,decisions_per_second,end_to_end_per_second\n" << std::setprecision(6);
+    for (const auto& record : records) {
+        out << record.agents << "," << record.workers << "," << record.timesteps << "," << record.decisions << "," << record.decision_ms << ","
+            << record.exchange_ms << "," << record.decisions_per_second << "," << record.end_to_end_per_second << "\n";
+    }
+}
@@ -1,89 +1,69 @@
 #include "enmod/CPSController.h"
+#include "enmod/DynamicSimulation.h"
 #include "enmod/Logger.h"
-#include <fstream>
+#include <chrono>
 #include <iostream>
+#include <stdexcept>
 
-CPSController::CPSController(const json& initial_config) : master_grid(initial_config) {
+CPSController::CPSController(const json& initial_config, std::unique_ptr<AgentTransport> transport)
+    : master_grid(initial_config), environment_feed(initial_config), solver(std::make_unique<HybridDPRLSolver>(master_grid)),
+      session(solver->getRLPolicy()), transport(std::move(transport)) {
     agent_position = master_grid.getStartPosition();
-    solver = std::make_unique<HybridDPRLSolver>(master_grid);
+    if (!this->transport) this->transport = AgentTransport::fromEnvironment();
 }
 
-void CPSController::write_input_file(int timestep) {
-    json input_data;
-    input_data["agent_id"] = agent_id;
-    input_data["timestep"] = timestep;
-    input_data["current_position"] = {
-        {"row", agent_position.row},
-        {"col", agent_position.col}
-    };
-    
-    // In a real system, this would come from sensors. Here we get it from the master grid.
-    input_data["environment_update"] = master_grid.getConfig();
-
-    std::ofstream o("agent_input.json");
-    o << std::setw(4) << input_data << std::endl;
-}
-
-Direction CPSController::read_output_file() {
-    std::ifstream i("agent_output.json");
-    json output_data;
-    i >> output_data;
-
-    std::string move = output_data.at("next_move");
-    if (move == "UP") return Direction::UP;
-    if (move == "DOWN") return Direction::DOWN;
-    if (move == "LEFT") return Direction::LEFT;
-    if (move == "RIGHT") return Direction::RIGHT;
-    return Direction::STAY;
-}
-
-
 void CPSController::run_simulation() {
-    std::cout << "\n===== Starting Real-Time CPS Simulation =====\n";
-    
-    for (int t = 0; t < 2 * (master_grid.getRows() * master_grid.getCols()); ++t) {
-        // 1. Simulate agent sending data to server
-        write_input_file(t);
-        Logger::log(LogLevel::INFO, "Timestep " + std::to_string(t) + ": Wrote agent_input.json");
+    std::cout << "\n===== Starting Real-Time CPS Simulation (" << transport->getName() << " transport) =====\n";
+    std::chrono::duration<double, std::micro> transport_time(0), decision_time(0);
+    int decisions = 0;
 
-        // 2. Server processes the data
-        std::ifstream i("agent_input.json");
-        json received_data;
-        i >> received_data;
+    for (int t = 0; t < 2 * (master_grid.getRows() * master_grid.getCols()); ++t) {
+        // 1. Agent sends its position and any hazards it observed since the last message
+        auto send_start = std::chrono::steady_clock::now();
+        if (!transport->sendObservation({agent_id, t, agent_position, environment_feed.next()})) {
+            throw std::runtime_error("CPS transport could not deliver the observation for timestep " + std::to_string(t));
+        }
 
-        Grid current_grid_state(received_data.at("environment_update"));
-        Position current_agent_pos = {
-            received_data.at("current_position").at("row"),
-            received_data.at("current_position").at("col")
-        };
-        
-        // 3. Server runs EnMod-DP and decides next move
-        Direction next_move = solver->getNextMove(current_agent_pos, current_grid_state);
+        // 2. Server picks it up
+        AgentObservation observation;
+        if (!transport->receiveObservation(observation)) {
+            throw std::runtime_error("CPS server received no observation for timestep " + std::to_string(t));
+        }
+        bool in_sync = session.apply(observation.environment);
+        transport_time += std::chrono::steady_clock::now() - send_start;
 
-        // 4. Server sends command back to agent
-        json output_data;
-        output_data["agent_id"] = agent_id;
-        std::string move_str = "STAY";
-        if (next_move == Direction::UP) move_str = "UP";
-        else if (next_move == Direction::DOWN) move_str = "DOWN";
-        else if (next_move == Direction::LEFT) move_str = "LEFT";
-        else if (next_move == Direction::RIGHT) move_str = "RIGHT";
-        output_data["next_move"] = move_str;
+        // 3. Server runs EnMod-DP on its persistent planning session and decides next move
+        AgentCommand reply = {observation.agent_id, t, Direction::STAY};
+        if (in_sync) {
+            auto decision_start = std::chrono::steady_clock::now();
+            reply.move = session.nextMove(observation.position);
+            decision_time += std::chrono::steady_clock::now() - decision_start;
+        } else {
+            reply.resync = true; // Hold position until a snapshot brings the server back in step
+        }
 
-        std::ofstream o("agent_output.json");
-        o << std::setw(4) << output_data << std::endl;
-        Logger::log(LogLevel::INFO, "Timestep " + std::to_string(t) + ": Wrote agent_output.json with move: " + move_str);
+        // 4. Server sends command back to agent, 5. agent receives and executes it
+        auto reply_start = std::chrono::steady_clock::now();
+        AgentCommand command;
+        if (!transport->sendCommand(reply) || !transport->receiveCommand(command)) {
+            throw std::runtime_error("CPS agent received no command for timestep " + std::to_string(t));
+        }
+        transport_time += std::chrono::steady_clock::now() - reply_start;
+        ++decisions;
+        if (command.resync) {
+            Logger::log(LogLevel::WARN, "Timestep " + std::to_string(t) + ": Server lost environment updates; sending a snapshot next.");
+            environment_feed.requestSnapshot();
+        }
 
-        // 5. Simulate agent receiving and executing the move
-        Direction received_move = read_output_file();
-        agent_position = master_grid.getNextPosition(agent_position, received_move);
-        
-        std::cout << "Timestep " << t << ": Agent at (" << agent_position.row << ", " << agent_position.col << ") received command: " << move_str << std::endl;
+        agent_position = master_grid.getNextPosition(agent_position, command.move);
+        Logger::log(LogLevel::INFO, "Timestep " + std::to_string(t) + ": Sent move " + actionName(command.move) + " to " + command.agent_id);
+        std::cout << "Timestep " << t << ": Agent at (" << agent_position.row << ", " << agent_position.col << ") received command: " << actionName(command.move) << std::endl;
 
         // Update the master grid with any dynamic events for the next timestep
         for (const auto& event_cfg : master_grid.getConfig().value("dynamic_events", json::array())) {
             if (event_cfg.value("time_step", -1) == t + 1) {
                 master_grid.addHazard(event_cfg);
+                environment_feed.recordFire(event_cfg);
             }
         }
         
@@ -93,4 +73,12 @@ void CPSController::run_simulation() {
             break;
         }
     }
-}
\ No newline at end of file
+
+    if (decisions > 0) {
+        double mean_us = transport_time.count() / decisions;
+        std::cout << "Mean transport latency per decision: " << mean_us << " us over " << decisions << " decisions.\n";
+        std::cout << "Mean planning time per decision: " << decision_time.count() / decisions << " us ("
+                  << session.getFieldRebuilds() << " cost-field rebuilds).\n";
+        Logger::log(LogLevel::INFO, "CPS " + transport->getName() + " transport: " + std::to_string(mean_us) + " us per decision.");
+    }
+}
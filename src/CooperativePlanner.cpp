@@ -0,0 +1,176 @@
+#include "enmod/CooperativePlanner.h"
+#include <algorithm>
+
+namespace {
+
+const Direction ACTIONS[] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT, Direction::STAY};
+
+} // namespace
+
+CooperativePlanner::CooperativePlanner(int window, int node_budget)
+    : window(std::clamp(window, 1, SpaceTimeReservations::MAX_WINDOW)), node_budget(std::max(1, node_budget)) {
+    std::size_t span = 2 * this->window + 1;
+    visited.resize(span * span * (this->window + 1));
+}
+
+void CooperativePlanner::beginRound(const Grid& grid_ref, std::uint64_t grid_version, const std::vector<Position>& agent_positions) {
+    if (grid != &grid_ref || cached_version != grid_version || move_costs.empty()) {
+        move_costs.resize(static_cast<std::size_t>(grid_ref.getRows()) * grid_ref.getCols());
+        for (int r = 0; r < grid_ref.getRows(); ++r) {
+            for (int c = 0; c < grid_ref.getCols(); ++c) move_costs[r * grid_ref.getCols() + c] = grid_ref.getMoveCost({r, c});
+        }
+        cached_version = grid_version;
+    }
+    grid = &grid_ref;
+    positions = agent_positions;
+    planned.assign(positions.size(), 0);
+    reservations.beginRound(positions.size() * (window + 1));
+    for (std::size_t i = 0; i < positions.size(); ++i) reservations.reserve(cellOf(positions[i]), 0, static_cast<int>(i));
+}
+
+// Whether the agent may be on `to` at timestep dt having been on `from` at dt - 1. Exits take any
+// number of agents and are never reserved.
+bool CooperativePlanner::canEnter(int agent, const Position& from, const Position& to, int dt) const {
+    if (grid->isExit(to.row, to.col)) return true;
+    int holder = reservations.owner(cellOf(to), dt);
+    if (holder >= 0 && holder != agent) return false;
+    if (to == from) return true;
+    int previous = reservations.owner(cellOf(to), dt - 1);
+    if (previous < 0 || previous == agent) return true;
+    if (dt == 1 && !planned[previous]) return false;              // Its occupant has not said where it goes
+    return reservations.owner(cellOf(from), dt) != previous;    // No swapping places
+}
+
+void CooperativePlanner::reservePath(int agent, int last_node) {
+    path.clear();
+    for (int n = last_node; n >= 0; n = nodes[n].parent) path.push_back(n);
+    for (int n : path) {
+        const Node& node = nodes[n];
+        if (node.dt > 0 && !grid->isExit(node.pos.row, node.pos.col)) reservations.reserve(cellOf(node.pos), node.dt, agent);
+    }
+    planned[agent] = 1;
+}
+
+Direction CooperativePlanner::directionTo(const Position& from, const Position& to) {
+    if (to.row < from.row) return Direction::UP;
+    if (to.row > from.row) return Direction::DOWN;
+    if (to.col < from.col) return Direction::LEFT;
+    if (to.col > from.col) return Direction::RIGHT;
+    return Direction::STAY;
+}
+
+// Walks the field downhill for the window. The path costs exactly the field value of its start,
+// which no plan can beat, so if every step of it is free it is reserved as the plan.
+bool CooperativePlanner::followField(int agent, const std::vector<std::vector<Cost>>& field) {
+    nodes.clear();
+    nodes.push_back({positions[agent], 0, -1, {0, 0, 0}, {0, 0, 0}});
+    for (int dt = 1; dt <= window; ++dt) {
+        const Position here = nodes.back().pos;
+        if (grid->isExit(here.row, here.col)) break;
+        Position best = here;
+        for (int a = 0; a < 4; ++a) {
+            Position next = grid->getNextPosition(here, ACTIONS[a]);
+            if (grid->isWalkable(next.row, next.col) && field[next.row][next.col] < field[best.row][best.col]) best = next;
+        }
+        if (best == here || !canEnter(agent, here, best, dt)) return false;
+        nodes.push_back({best, dt, static_cast<int>(nodes.size()) - 1, {0, 0, 0}, {0, 0, 0}});
+    }
+    reservePath(agent, static_cast<int>(nodes.size()) - 1);
+    return true;
+}
+
+Direction CooperativePlanner::plan(int agent, const std::vector<std::vector<Cost>>& field) {
+    const Position start = positions[agent];
+    if (field[start.row][start.col].distance == MAX_COST) { // No way out from here
+        hold(agent);
+        return Direction::STAY;
+    }
+    if (followField(agent, field)) return directionTo(start, nodes[1].pos);
+
+    if (++search == 0) { // The stamp wrapped
+        for (auto& slot : visited) slot.search = 0;
+        search = 1;
+    }
+    origin = start;
+    nodes.clear();
+    open.clear();
+    const bool normal = Cost::current_mode == EvacuationMode::NORMAL;
+    auto entry = [&](int n) {
+        const Cost& f = nodes[n].f;
+        return normal ? OpenEntry{{f.time, f.distance, f.smoke}, nodes[n].dt, n} : OpenEntry{{f.smoke, f.time, f.distance}, nodes[n].dt, n};
+    };
+    // Lowest f first; among equals the deeper node, then the older one, so ties break the same way every run
+    auto worse = [](const OpenEntry& x, const OpenEntry& y) {
+        for (int i = 0; i < 3; ++i) {
+            if (x.key[i] != y.key[i]) return x.key[i] > y.key[i];
+        }
+        if (x.dt != y.dt) return x.dt < y.dt;
+        return x.node > y.node;
+    };
+
+    nodes.push_back({start, 0, -1, {0, 0, 0}, field[start.row][start.col]});
+    visitedNode(start, 0) = 0;
+    open.push_back(entry(0));
+    int goal = -1;
+    int best = 0; // Closest to an exit among the expanded nodes, in case the budget runs out
+    int expanded = 0;
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), worse);
+        int current = open.back().node;
+        open.pop_back();
+        Node node = nodes[current];
+        if (node.dt == window || grid->isExit(node.pos.row, node.pos.col)) {
+            goal = current;
+            break;
+        }
+        if (++expanded > node_budget) break;
+        ++expansions;
+        const Cost& here = field[node.pos.row][node.pos.col];
+        const Cost& best_here = field[nodes[best].pos.row][nodes[best].pos.col];
+        if (here < best_here || (here == best_here && node.dt > nodes[best].dt)) best = current;
+
+        const Cost& leave = moveCost(node.pos); // As in BIDP, a step costs what the cell it leaves costs
+        Cost wait = {leave.smoke, leave.time, 0};
+        for (Direction action : ACTIONS) {
+            Position next = grid->getNextPosition(node.pos, action);
+            if (!grid->isWalkable(next.row, next.col)) continue;
+            const Cost& remaining = field[next.row][next.col];
+            if (remaining.distance == MAX_COST) continue;
+            if (!canEnter(agent, node.pos, next, node.dt + 1)) continue;
+            Cost g = node.g + (action == Direction::STAY ? wait : leave);
+            int& seen = visitedNode(next, node.dt + 1);
+            if (seen >= 0 && !(g < nodes[seen].g)) continue;
+            seen = static_cast<int>(nodes.size());
+            nodes.push_back({next, node.dt + 1, current, g, g + remaining});
+            open.push_back(entry(seen));
+            std::push_heap(open.begin(), open.end(), worse);
+        }
+    }
+
+    int last = goal >= 0 ? goal : best;
+    reservePath(agent, last);
+    if (last == 0) return Direction::STAY;
+    int first = last;
+    while (nodes[first].parent != 0) first = nodes[first].parent;
+    return directionTo(start, nodes[first].pos);
+}
+
+Direction CooperativePlanner::claim(int agent, Direction move) {
+    const Position start = positions[agent];
+    Position target = grid->getNextPosition(start, move);
+    if (!grid->isWalkable(target.row, target.col) || !canEnter(agent, start, target, 1)) {
+        move = Direction::STAY;
+        target = start;
+    }
+    if (!grid->isExit(target.row, target.col)) reservations.reserve(cellOf(target), 1, agent);
+    planned[agent] = 1;
+    return move;
+}
+
+void CooperativePlanner::hold(int agent) {
+    const Position pos = positions[agent];
+    if (!grid->isExit(pos.row, pos.col)) {
+        for (int dt = 1; dt <= window; ++dt) reservations.reserve(cellOf(pos), dt, agent);
+    }
+    planned[agent] = 1;
+}
@@ -32,3 +32,7 @@ std::ostream& operator<<(std::ostream& os, const Cost& cost) {
     return os;
 }
 
+double weightedCost(const Cost& cost) {
+    if (cost.distance == MAX_COST) return std::numeric_limits<double>::infinity();
+    return (cost.smoke * 1000) + (cost.time * 10) + (cost.distance * 1);
+}
@@ -1,10 +1,10 @@
 #include "enmod/DynamicActorCriticSolver.h"
+#include "enmod/BatchEnvironment.h"
+#include "enmod/DynamicSimulation.h"
 #include "enmod/Logger.h"
 
 DynamicActorCriticSolver::DynamicActorCriticSolver(const Grid& grid_ref) 
-    : ActorCriticSolver(grid_ref) {
-    solver_name = "DynamicActorCriticSim";
-}
+    : ActorCriticSolver(grid_ref, "DynamicActorCriticSim") {}
 
 void DynamicActorCriticSolver::run() {
     Grid dynamic_grid = grid;
@@ -33,16 +33,7 @@ void DynamicActorCriticSolver::run() {
         Direction move_dir = chooseAction(current_pos);
         Position next_pos = dynamic_grid.getNextPosition(current_pos, move_dir);
         
-        double reward = -1;
-        if (!dynamic_grid.isWalkable(next_pos.row, next_pos.col)) {
-            reward = -100; next_pos = current_pos;
-        } else if (dynamic_grid.isExit(next_pos.row, next_pos.col)) {
-            reward = 1000;
-        } else if (dynamic_grid.getCellType(next_pos) == CellType::FIRE) {
-            reward = -200;
-        } else if (dynamic_grid.getCellType(next_pos) == CellType::SMOKE) {
-            reward = -20;
-        }
+        double reward = BatchEnvironment::transitionReward(dynamic_grid, current_pos, next_pos);
 
         update(current_pos, move_dir, reward, next_pos, chooseAction(next_pos));
         
@@ -74,3 +65,7 @@ void DynamicActorCriticSolver::generateReport(std::ofstream& report_file) const
     }
 }
 
+bool DynamicActorCriticSolver::writeReplay(const std::string& path, std::uint64_t seed) const {
+    return writeSimulationReplay(path, grid, history, seed);
+}
+
@@ -0,0 +1,24 @@
+#include "enmod/DynamicFeatureQLearningSolver.h"
+#include "enmod/FeatureQLearningSolver.h"
+
+DynamicFeatureQLearningSolver::DynamicFeatureQLearningSolver(const Grid& grid_ref)
+    : Solver(grid_ref, "DynamicFeatureQSim"), simulation(grid_ref), step_policy(model) {}
+
+void DynamicFeatureQLearningSolver::run() {
+    if (!pretrained) {
+        FeatureQLearningSolver trainer(grid);
+        trainer.run();
+        model = trainer.getModel();
+    }
+    total_cost = simulation.run(step_policy, history);
+}
+
+Cost DynamicFeatureQLearningSolver::getEvacuationCost() const { return total_cost; }
+
+void DynamicFeatureQLearningSolver::generateReport(std::ofstream& report_file) const {
+    writeSimulationHistory(report_file, "Simulation History (Turn-by-Turn with a Fixed Feature-based Q Model)", history);
+}
+
+bool DynamicFeatureQLearningSolver::writeReplay(const std::string& path, std::uint64_t seed) const {
+    return writeSimulationReplay(path, grid, history, seed);
+}
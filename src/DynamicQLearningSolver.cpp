@@ -1,8 +1,14 @@
 #include "enmod/DynamicQLearningSolver.h"
+#include "enmod/BatchEnvironment.h"
+#include "enmod/DynamicSimulation.h"
 #include "enmod/Logger.h"
 
 DynamicQLearningSolver::DynamicQLearningSolver(const Grid& grid_ref) 
-    : QLearningSolver(grid_ref, "DynamicQLearningSim") {}
+    : QLearningSolver(grid_ref, "DynamicQLearningSim") {
+    // Replay and model-based planning squeeze more learning out of each real step,
+    // which matters most once the agent is moving and hazards start to spread.
+    enableReplay();
+}
 
 void DynamicQLearningSolver::run() {
     Grid dynamic_grid = grid;
@@ -10,7 +16,7 @@ void DynamicQLearningSolver::run() {
     total_cost = {0, 0, 0};
     history.clear();
     
-    train(1000); // Initial offline training
+    train(OFFLINE_EPISODES); // Initial offline training
 
     const auto& events = dynamic_grid.getConfig().value("dynamic_events", json::array());
 
@@ -31,16 +37,7 @@ void DynamicQLearningSolver::run() {
         Direction move_dir = chooseAction(current_pos);
         Position next_pos = dynamic_grid.getNextPosition(current_pos, move_dir);
         
-        double reward = -1;
-        if (!dynamic_grid.isWalkable(next_pos.row, next_pos.col)) {
-            reward = -100; next_pos = current_pos;
-        } else if (dynamic_grid.isExit(next_pos.row, next_pos.col)) {
-            reward = 1000;
-        } else if (dynamic_grid.getCellType(next_pos) == CellType::FIRE) {
-            reward = -200;
-        } else if (dynamic_grid.getCellType(next_pos) == CellType::SMOKE) {
-            reward = -20;
-        }
+        double reward = BatchEnvironment::transitionReward(dynamic_grid, current_pos, next_pos);
 
         update(current_pos, move_dir, reward, next_pos, chooseAction(next_pos));
         
@@ -66,6 +63,7 @@ Cost DynamicQLearningSolver::getEvacuationCost() const { return total_cost; }
 
 void DynamicQLearningSolver::generateReport(std::ofstream& report_file) const {
     report_file << "<h2>Simulation History (Turn-by-Turn with Online Q-Learning)</h2>\n";
+    writeReplaySummary(report_file);
     for (const auto& step : history) {
         report_file << "<h3>Time Step: " << step.time_step << "</h3>\n";
         report_file << "<p><strong>Agent Position:</strong> (" << step.agent_pos.row << ", " << step.agent_pos.col << ")</p>\n";
@@ -73,4 +71,8 @@ void DynamicQLearningSolver::generateReport(std::ofstream& report_file) const {
         report_file << "<p><strong>Cumulative Cost:</strong> " << step.current_total_cost << "</p>\n";
         report_file << step.grid_state.toHtmlStringWithAgent(step.agent_pos);
     }
+}
+
+bool DynamicQLearningSolver::writeReplay(const std::string& path, std::uint64_t seed) const {
+    return writeSimulationReplay(path, grid, history, seed);
 }
\ No newline at end of file
@@ -1,10 +1,10 @@
 #include "enmod/DynamicSARSASolver.h"
+#include "enmod/BatchEnvironment.h"
+#include "enmod/DynamicSimulation.h"
 #include "enmod/Logger.h"
 
 DynamicSARSASolver::DynamicSARSASolver(const Grid& grid_ref) 
-    : SARSASolver(grid_ref) {
-    solver_name = "DynamicSARSASim";
-}
+    : SARSASolver(grid_ref, "DynamicSARSASim") {}
 
 void DynamicSARSASolver::run() {
     Grid dynamic_grid = grid;
@@ -33,16 +33,7 @@ void DynamicSARSASolver::run() {
 
         Position next_pos = dynamic_grid.getNextPosition(current_pos, action);
         
-        double reward = -1;
-        if (!dynamic_grid.isWalkable(next_pos.row, next_pos.col)) {
-            reward = -100; next_pos = current_pos;
-        } else if (dynamic_grid.isExit(next_pos.row, next_pos.col)) {
-            reward = 1000;
-        } else if (dynamic_grid.getCellType(next_pos) == CellType::FIRE) {
-            reward = -200;
-        } else if (dynamic_grid.getCellType(next_pos) == CellType::SMOKE) {
-            reward = -20;
-        }
+        double reward = BatchEnvironment::transitionReward(dynamic_grid, current_pos, next_pos);
 
         Direction next_action = chooseAction(next_pos);
         update(current_pos, action, reward, next_pos, next_action);
@@ -76,3 +67,7 @@ void DynamicSARSASolver::generateReport(std::ofstream& report_file) const {
     }
 }
 
+bool DynamicSARSASolver::writeReplay(const std::string& path, std::uint64_t seed) const {
+    return writeSimulationReplay(path, grid, history, seed);
+}
+
@@ -0,0 +1,164 @@
+#include "enmod/DynamicSimulation.h"
+#include "enmod/Profiler.h"
+#include "enmod/ReplayLog.h"
+#include "enmod/Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+
+EvacuationMode assessThreat(const Position& current_pos, const Grid& current_grid) {
+    // Looked up in place: json::value() would copy the event list on every call
+    static const json no_events = json::array();
+    const json& config = current_grid.getConfig();
+    auto found = config.find("dynamic_events");
+    const json& events = found != config.end() ? *found : no_events;
+    EvacuationMode mode = EvacuationMode::NORMAL;
+
+    for (const auto& event : events) {
+        if (event.value("type", "") == "fire") {
+            Position fire_pos = {event.at("position").at("row"), event.at("position").at("col")};
+            if (current_grid.getCellType(fire_pos) == CellType::FIRE) {
+                int radius = event.value("impact_radius", 1);
+                if(event.value("size", "small") == "medium") radius = 2;
+                if(event.value("size", "small") == "large") radius = 3;
+
+                int dist = std::abs(current_pos.row - fire_pos.row) + std::abs(current_pos.col - fire_pos.col);
+                if (dist <= 1) return EvacuationMode::PANIC;
+                if (dist <= radius) mode = EvacuationMode::ALERT;
+            }
+        }
+    }
+
+    int dr[] = {-1, 1, 0, 0};
+    int dc[] = {0, 0, -1, 1};
+    for(int i = 0; i < 4; ++i) {
+        Position neighbor = {current_pos.row + dr[i], current_pos.col + dc[i]};
+        if(current_grid.getSmokeIntensity(neighbor) == "heavy") mode = EvacuationMode::ALERT;
+    }
+    return mode;
+}
+
+DynamicSimulation::DynamicSimulation(const Grid& initial_grid)
+    : initial_grid(initial_grid), max_steps(2 * initial_grid.getRows() * initial_grid.getCols()) {
+    // Events without a time step never fire; the rest are applied in config order within a step
+    const json& config = initial_grid.getConfig();
+    if (!config.contains("dynamic_events")) return;
+    for (const auto& event : config.at("dynamic_events")) {
+        int time_step = event.value("time_step", -1);
+        if (time_step >= 0) timeline.push_back({time_step, &event});
+    }
+    std::stable_sort(timeline.begin(), timeline.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+}
+
+Cost DynamicSimulation::run(StepPolicy& policy, std::vector<StepReport>& history) const {
+    Grid dynamic_grid = initial_grid;
+    Position current_pos = dynamic_grid.getStartPosition();
+    Cost total_cost = {0, 0, 0};
+    EvacuationMode current_mode = EvacuationMode::NORMAL;
+    std::size_t next_event = 0;
+    bool finished = false;
+    history.clear();
+    policy.reset();
+
+    for (int t = 0; t < max_steps; ++t) {
+        while (next_event < timeline.size() && timeline[next_event].first == t) {
+            dynamic_grid.addHazard(*timeline[next_event++].second);
+        }
+        current_mode = assessThreat(current_pos, dynamic_grid);
+        Cost::current_mode = current_mode;
+        ENMOD_PROFILE_COUNT(COUNTER_SIM_STEPS, 1);
+        {
+            ENMOD_PROFILE_PHASE(PHASE_HISTORY);
+            history.push_back({t, dynamic_grid, current_pos, "Planning...", total_cost, current_mode});
+        }
+
+        if (dynamic_grid.isExit(current_pos.row, current_pos.col)) {
+            history.back().action = "SUCCESS: Reached Exit.";
+            finished = true;
+            break;
+        }
+
+        StepDecision decision = policy.decide(dynamic_grid, current_pos, current_mode, t);
+        if (decision.no_path) {
+            history.back().action = "FAILURE: No path found.";
+            total_cost = {};
+            finished = true;
+            break;
+        }
+
+        history.back().action = decision.action;
+        total_cost = total_cost + dynamic_grid.getMoveCost(current_pos);
+        current_pos = decision.next_pos;
+    }
+    if (!finished) {
+        history.push_back({(int)history.size(), dynamic_grid, current_pos, "FAILURE: Timed out.", total_cost, current_mode});
+        total_cost = {};
+    }
+    Cost::current_mode = EvacuationMode::NORMAL;
+    return total_cost;
+}
+
+void writeSimulationHistory(std::ofstream& report_file, const std::string& title, const std::vector<StepReport>& history) {
+    report_file << "<h2>" << title << "</h2>\n";
+    for (const auto& step : history) {
+        std::string mode_str;
+        switch(step.mode){
+            case EvacuationMode::NORMAL: mode_str = "NORMAL"; break;
+            case EvacuationMode::ALERT: mode_str = "ALERT"; break;
+            case EvacuationMode::PANIC: mode_str = "PANIC"; break;
+        }
+        report_file << "<h3>Time Step: " << step.time_step << " (Mode: " << mode_str << ")</h3>\n";
+        report_file << "<p><strong>Agent Position:</strong> (" << step.agent_pos.row << ", " << step.agent_pos.col << ")</p>\n";
+        report_file << "<p><strong>Action Taken:</strong> " << step.action << "</p>\n";
+        report_file << "<p><strong>Cumulative Cost:</strong> " << step.current_total_cost << "</p>\n";
+        report_file << step.grid_state.toHtmlStringWithAgent(step.agent_pos);
+    }
+}
+
+bool writeSimulationReplay(const std::string& path, const Grid& initial_grid, const std::vector<StepReport>& history, std::uint64_t seed) {
+    if (history.empty()) return false;
+    // The same timeline DynamicSimulation plays: by time step, in config order within a step
+    const json& config = initial_grid.getConfig();
+    std::vector<std::pair<int, std::size_t>> timeline;
+    auto events = config.find("dynamic_events");
+    if (events != config.end()) {
+        for (std::size_t i = 0; i < events->size(); ++i) {
+            int time_step = (*events)[i].value("time_step", -1);
+            if (time_step >= 0) timeline.push_back({time_step, i});
+        }
+    }
+    std::stable_sort(timeline.begin(), timeline.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    try {
+        ReplayRecorder replay(path, config, seed, {history.front().agent_pos});
+        std::size_t next_event = 0;
+        for (std::size_t t = 0; t < history.size(); ++t) {
+            int time_step = static_cast<int>(t);
+            while (next_event < timeline.size() && timeline[next_event].first <= time_step) replay.recordHazard(time_step, timeline[next_event++].second);
+            // The move is read off the next position; anything else is kept exact by a keyframe
+            Direction move = Direction::STAY;
+            if (t + 1 < history.size()) {
+                const Position& from = history[t].agent_pos;
+                const Position& to = history[t + 1].agent_pos;
+                for (Direction dir : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT}) {
+                    if (initial_grid.getNextPosition(from, dir) == to) move = dir;
+                }
+            }
+            replay.recordStep(time_step, {history[t].agent_pos}, {move}, {history[t].mode});
+        }
+    } catch (const std::exception& e) {
+        Logger::log(LogLevel::WARN, "Could not write replay " + path + ": " + e.what());
+        return false;
+    }
+    return true;
+}
+
+std::string actionName(Direction dir, const std::string& suffix) {
+    switch (dir) {
+        case Direction::UP: return "UP" + suffix;
+        case Direction::DOWN: return "DOWN" + suffix;
+        case Direction::LEFT: return "LEFT" + suffix;
+        case Direction::RIGHT: return "RIGHT" + suffix;
+        default: return "STAY";
+    }
+}
@@ -0,0 +1,44 @@
+#include "enmod/EligibilityTraces.h"
+#include <algorithm>
+
+EligibilityTraces::EligibilityTraces(int num_keys, int capacity, double cutoff)
+    : slot_of(num_keys, -1), keys(std::max(1, capacity)), values(std::max(1, capacity)), cutoff(cutoff) {}
+
+void EligibilityTraces::clear() {
+    for (int i = 0; i < count; ++i) slot_of[keys[i]] = -1;
+    count = 0;
+}
+
+void EligibilityTraces::visit(int cell, int action) {
+    int key = cell * NUM_ACTIONS + action;
+    for (int other = cell * NUM_ACTIONS; other < (cell + 1) * NUM_ACTIONS; ++other) {
+        if (other != key && slot_of[other] >= 0) remove(slot_of[other]);
+    }
+    int slot = slot_of[key];
+    if (slot < 0) {
+        if (count == static_cast<int>(keys.size())) {
+            remove(static_cast<int>(std::min_element(values.begin(), values.begin() + count) - values.begin()));
+        }
+        slot = count++;
+        keys[slot] = key;
+        slot_of[key] = slot;
+    }
+    values[slot] = 1.0;
+}
+
+void EligibilityTraces::decay(double factor) {
+    for (int i = 0; i < count; ++i) {
+        values[i] *= factor;
+        if (values[i] < cutoff) remove(i--);
+    }
+}
+
+void EligibilityTraces::remove(int slot) {
+    slot_of[keys[slot]] = -1;
+    --count;
+    if (slot != count) {
+        keys[slot] = keys[count];
+        values[slot] = values[count];
+        slot_of[keys[slot]] = slot;
+    }
+}
@@ -0,0 +1,99 @@
+#include "enmod/EnvironmentDelta.h"
+
+json EnvironmentUpdate::toJson() const {
+    json data;
+    data["sequence"] = sequence;
+    if (is_snapshot) data["snapshot"] = *snapshot;
+    data["changes"] = json::array();
+    for (const auto& change : changes) {
+        json entry = {{"position", {{"row", change.pos.row}, {"col", change.pos.col}}}};
+        if (change.kind == EnvironmentChange::Kind::FIRE) {
+            entry["type"] = "fire";
+            entry["size"] = change.size;
+        } else {
+            entry["type"] = "blocked";
+        }
+        data["changes"].push_back(entry);
+    }
+    return data;
+}
+
+EnvironmentUpdate EnvironmentUpdate::fromJson(const json& data) {
+    EnvironmentUpdate update;
+    update.sequence = data.at("sequence");
+    update.is_snapshot = data.contains("snapshot");
+    if (update.is_snapshot) update.snapshot = std::make_shared<const json>(data.at("snapshot"));
+    for (const auto& entry : data.at("changes")) {
+        EnvironmentChange change;
+        change.kind = entry.at("type") == "blocked" ? EnvironmentChange::Kind::BLOCKED : EnvironmentChange::Kind::FIRE;
+        change.pos = {entry.at("position").at("row"), entry.at("position").at("col")};
+        change.size = entry.value("size", "small");
+        update.changes.push_back(change);
+    }
+    return update;
+}
+
+EnvironmentDeltaEncoder::EnvironmentDeltaEncoder(const json& config) : config(std::make_shared<const json>(config)) {}
+
+EnvironmentDeltaEncoder::EnvironmentDeltaEncoder(std::shared_ptr<const json> config) : config(std::move(config)) {}
+
+void EnvironmentDeltaEncoder::recordFire(const json& event_config) {
+    EnvironmentChange change;
+    change.pos = {event_config.at("position").at("row"), event_config.at("position").at("col")};
+    change.size = event_config.value("size", "small");
+    history.push_back(change);
+}
+
+EnvironmentUpdate EnvironmentDeltaEncoder::next() {
+    EnvironmentUpdate update;
+    update.sequence = ++sequence;
+    if (snapshot_due) {
+        update.is_snapshot = true;
+        update.snapshot = config;
+        update.changes = history;
+        snapshot_due = false;
+    } else {
+        update.changes.assign(history.begin() + sent, history.end());
+    }
+    sent = history.size();
+    return update;
+}
+
+bool EnvironmentMirror::apply(const EnvironmentUpdate& update, const std::string& sender) {
+    if (update.is_snapshot) {
+        if (!update.snapshot) return false;
+        if (!grid) {
+            grid = std::make_unique<Grid>(*update.snapshot);
+            ++version;
+        }
+    } else {
+        auto last = sequences.find(sender);
+        if (!grid || last == sequences.end() || update.sequence != last->second + 1) return false;
+    }
+    for (const auto& change : update.changes) applyChange(change);
+    sequences[sender] = update.sequence;
+    return true;
+}
+
+void EnvironmentMirror::reset(const Grid& initial_grid) {
+    grid = std::make_unique<Grid>(initial_grid);
+    sequences.clear();
+    sequences[""] = 0;
+    applied.clear();
+    ++version;
+}
+
+std::uint64_t EnvironmentMirror::getSequence(const std::string& sender) const {
+    auto last = sequences.find(sender);
+    return last == sequences.end() ? 0 : last->second;
+}
+
+void EnvironmentMirror::applyChange(const EnvironmentChange& change) {
+    if (!applied.insert({static_cast<int>(change.kind), change.pos.row, change.pos.col, change.size}).second) return;
+    ++version;
+    if (change.kind == EnvironmentChange::Kind::BLOCKED) {
+        grid->setCellUnwalkable(change.pos);
+        return;
+    }
+    grid->addHazard({{"position", {{"row", change.pos.row}, {"col", change.pos.col}}}, {"size", change.size}});
+}
@@ -0,0 +1,82 @@
+#include "enmod/ExitAssignment.h"
+#include <algorithm>
+
+ExitAssignment::ExitAssignment(const Grid& grid) {
+    static const Direction dirs[] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+    for (const auto& exit_cfg : grid.getConfig().value("exits", json::array())) {
+        Position exit_pos = {exit_cfg.at("row"), exit_cfg.at("col")};
+        int approaches = 0;
+        for (Direction dir : dirs) {
+            Position neighbor = grid.getNextPosition(exit_pos, dir);
+            if (grid.isWalkable(neighbor.row, neighbor.col)) ++approaches;
+        }
+        capacities.push_back(std::max(1, exit_cfg.value("capacity", approaches)));
+    }
+    booked.resize(capacities.size());
+    next_open.resize(capacities.size());
+}
+
+int ExitAssignment::firstOpen(int exit, int timestep) {
+    std::vector<int>& parent = next_open[exit];
+    int root = timestep;
+    while (parent[root] != root) root = parent[root];
+    while (parent[timestep] != root) { // Path compression
+        int next = parent[timestep];
+        parent[timestep] = root;
+        timestep = next;
+    }
+    return root;
+}
+
+void ExitAssignment::solve(const std::vector<int>& distances, std::vector<int>& exits, int switch_margin) {
+    const int num_exits = getNumExits();
+    const int num_agents = num_exits > 0 ? static_cast<int>(distances.size()) / num_exits : 0;
+    exits.resize(num_agents, -1);
+    clearance_time = 0;
+
+    order.clear();
+    int horizon = 0;
+    for (int a = 0; a < num_agents; ++a) {
+        int nearest = MAX_COST;
+        for (int e = 0; e < num_exits; ++e) nearest = std::min(nearest, distances[a * num_exits + e]);
+        if (nearest == MAX_COST) {
+            exits[a] = -1;
+            continue;
+        }
+        order.push_back({nearest, a});
+        for (int e = 0; e < num_exits; ++e) {
+            if (distances[a * num_exits + e] != MAX_COST) horizon = std::max(horizon, distances[a * num_exits + e]);
+        }
+    }
+    std::sort(order.begin(), order.end());
+
+    // No exit can be busy for longer than the whole crowd queueing at it
+    horizon += static_cast<int>(order.size()) + 1;
+    for (int e = 0; e < num_exits; ++e) {
+        booked[e].assign(horizon + 1, 0);
+        next_open[e].resize(horizon + 1);
+        for (int t = 0; t <= horizon; ++t) next_open[e][t] = t;
+    }
+
+    for (const auto& entry : order) {
+        int agent = entry.second;
+        int previous = exits[agent];
+        int best_exit = -1;
+        int best_score = MAX_COST;
+        int best_time = 0;
+        for (int e = 0; e < num_exits; ++e) {
+            int distance = distances[agent * num_exits + e];
+            if (distance == MAX_COST) continue;
+            int time = firstOpen(e, distance);
+            int score = time + (previous >= 0 && e != previous ? switch_margin : 0);
+            if (score < best_score) {
+                best_score = score;
+                best_exit = e;
+                best_time = time;
+            }
+        }
+        exits[agent] = best_exit;
+        if (++booked[best_exit][best_time] == capacities[best_exit]) next_open[best_exit][best_time] = best_time + 1;
+        clearance_time = std::max(clearance_time, best_time);
+    }
+}
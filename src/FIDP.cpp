@@ -1,5 +1,6 @@
 #include "enmod/FIDP.h"
 #include "enmod/HtmlReportGenerator.h"
+#include "enmod/Profiler.h"
 #include <queue>
 #include <vector>
 #include <algorithm> 
@@ -13,13 +14,18 @@ void FIDP::run() {
 
 // NEW overloaded run method that accepts a starting position
 void FIDP::run(const Position& start_pos) {
-    cost_map.assign(grid.getRows(), std::vector<Cost>(grid.getCols()));
-    parent_map.assign(grid.getRows(), std::vector<Position>(grid.getCols(), {-1, -1}));
+    {
+        ENMOD_PROFILE_PHASE(PHASE_PLANNER_SETUP);
+        cost_map.assign(grid.getRows(), std::vector<Cost>(grid.getCols()));
+        parent_map.assign(grid.getRows(), std::vector<Position>(grid.getCols(), {-1, -1}));
+    }
+    ENMOD_PROFILE_PHASE(PHASE_PLANNING);
 
     std::priority_queue<std::pair<Cost, Position>, std::vector<std::pair<Cost, Position>>, std::greater<std::pair<Cost, Position>>> pq;
 
     cost_map[start_pos.row][start_pos.col] = {0, 0, 0};
     pq.push({{0, 0, 0}, start_pos});
+    ENMOD_PROFILE_COUNT(COUNTER_HEAP_PUSHES, 1);
     parent_map[start_pos.row][start_pos.col] = start_pos;
 
     int dr[] = {-1, 1, 0, 0};
@@ -28,6 +34,7 @@ void FIDP::run(const Position& start_pos) {
     while (!pq.empty()) {
         auto [current_cost, current_pos] = pq.top();
         pq.pop();
+        ENMOD_PROFILE_COUNT(COUNTER_HEAP_POPS, 1);
 
         if (cost_map[current_pos.row][current_pos.col] < current_cost) {
             continue;
@@ -43,6 +50,8 @@ void FIDP::run(const Position& start_pos) {
                 if (new_cost < cost_map[next_pos.row][next_pos.col]) {
                     cost_map[next_pos.row][next_pos.col] = new_cost;
                     pq.push({new_cost, next_pos});
+                    ENMOD_PROFILE_COUNT(COUNTER_HEAP_PUSHES, 1);
+                    ENMOD_PROFILE_COUNT(COUNTER_RELAXATIONS, 1);
                     parent_map[next_pos.row][next_pos.col] = current_pos;
                 }
             }
@@ -0,0 +1,118 @@
+#include "enmod/FeatureQLearningSolver.h"
+#include "enmod/BatchEnvironment.h"
+#include "enmod/QLearningSolver.h"
+#include "enmod/BIDP.h"
+#include <algorithm>
+#include <vector>
+
+FeatureQLearningSolver::FeatureQLearningSolver(const Grid& grid_ref, const std::string& name)
+    : Solver(grid_ref, name), policy(grid_ref.getRows(), grid_ref.getCols()), rng(deriveSeed(RLSolver::run_seed, name)) {}
+
+void FeatureQLearningSolver::buildFeatures() {
+    if (!features) features = std::make_unique<FeatureGrid>(grid);
+}
+
+void FeatureQLearningSolver::fitToCostMap(const std::vector<std::vector<Cost>>& cost_map) {
+    buildFeatures();
+    // The tabular bootstrap gives the greedy action for every reachable cell. Regressing the raw
+    // Q-values lets the large blocked-move penalty swamp the distance weight, so fit the ranking only
+    QLearningSolver teacher(grid);
+    teacher.initializeFromCostMap(cost_map);
+    const ValueTable& targets = teacher.getValueTable();
+
+    float q[NUM_ACTIONS];
+    for (int epoch = 0; epoch < FIT_EPOCHS; ++epoch) {
+        for (int cell = 0; cell < targets.numCells(); ++cell) {
+            if (!targets.isVisited(cell)) continue;
+            const float* f = features->features(cell);
+            int best = targets.bestAction(cell);
+            model.evaluate(f, q);
+            for (int a = 0; a < NUM_ACTIONS; ++a) {
+                double target = a == best ? 0.0 : -1.0;
+                model.update(f, a, static_cast<float>(target - q[a]), alpha);
+            }
+        }
+    }
+}
+
+void FeatureQLearningSolver::train(int episodes) {
+    buildFeatures();
+    BatchEnvironment env(grid);
+    int horizon = grid.getRows() * grid.getCols();
+    float q[NUM_ACTIONS], next_q[NUM_ACTIONS];
+
+    for (int episode = 0; episode < episodes; ++episode) {
+        int cell = env.startCell();
+        for (int t = 0; t < horizon && !env.isTerminal(cell); ++t) {
+            const float* f = features->features(cell);
+            int action = rng.uniform() < epsilon ? rng.nextInt(NUM_ACTIONS) : model.bestAction(f);
+            int next_cell = env.nextCell(cell, action);
+
+            double target = env.reward(cell, action) * REWARD_SCALE;
+            if (!env.isTerminal(next_cell)) {
+                model.evaluate(features->features(next_cell), next_q);
+                target += gamma * *std::max_element(next_q, next_q + NUM_ACTIONS);
+            }
+            model.evaluate(f, q);
+            model.update(f, action, static_cast<float>(target - q[action]), alpha);
+            cell = next_cell;
+        }
+    }
+    episodes_trained += episodes;
+}
+
+Direction FeatureQLearningSolver::chooseAction(const Position& state) const {
+    return static_cast<Direction>(model.bestAction(features->features(features->cellIndex(state))));
+}
+
+void FeatureQLearningSolver::run() {
+    buildFeatures();
+    if (!pretrained) {
+        // Every run fits from scratch; carrying weights over is setModel's job
+        model = LinearQModel();
+        episodes_trained = 0;
+        BIDP field(grid);
+        field.run();
+        fitToCostMap(field.getCostMap());
+    }
+    for (int r = 0; r < grid.getRows(); ++r) {
+        for (int c = 0; c < grid.getCols(); ++c) {
+            if (grid.isWalkable(r, c)) policy.setDirection({r, c}, chooseAction({r, c}));
+        }
+    }
+}
+
+Cost FeatureQLearningSolver::getEvacuationCost() const {
+    Position current = grid.getStartPosition();
+    Cost total_cost = {0, 0, 0};
+    std::vector<Position> path;
+    for (int i = 0; i < grid.getRows() * grid.getCols() + 1; ++i) {
+        path.push_back(current);
+        if (grid.isExit(current.row, current.col)) return total_cost;
+        Direction dir = policy.getDirection(current);
+        if (dir == Direction::NONE) return {};
+        total_cost = total_cost + grid.getMoveCost(current);
+        current = grid.getNextPosition(current, dir);
+        if(std::find(path.begin(), path.end(), current) != path.end()) return {};
+    }
+    return {};
+}
+
+void FeatureQLearningSolver::generateReport(std::ofstream& report_file) const {
+    static const char* feature_names[NUM_FEATURES] = {"bias", "blocked", "exit", "fire", "smoke",
+                                                      "BIDP distance change", "fire nearby", "smoke nearby"};
+    report_file << "<h2>Final Learned Policy (Feature-based Q-Learning)</h2>\n";
+    if (pretrained) {
+        report_file << "<p>This policy was produced by a pre-trained model without training on this grid.</p>\n";
+    } else {
+        report_file << "<p>This policy was fitted to the BIDP field of this grid";
+        if (episodes_trained > 0) report_file << " and fine-tuned over " << episodes_trained << " episodes";
+        report_file << ".</p>\n";
+    }
+    report_file << "<table><tr><th>Feature</th><th>Weight</th></tr>\n";
+    for (int f = 0; f < NUM_FEATURES; ++f) {
+        report_file << "<tr><td>" << feature_names[f] << "</td><td>" << model.getWeights()[f] << "</td></tr>\n";
+    }
+    report_file << "</table>\n";
+    report_file << grid.toHtmlStringWithPolicy(policy);
+}
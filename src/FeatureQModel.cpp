@@ -0,0 +1,122 @@
+#include "enmod/FeatureQModel.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <queue>
+#include <utility>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define ENMOD_FEATURE_SSE 1
+#endif
+
+static_assert(NUM_ACTIONS == 4, "the inference kernel evaluates exactly four actions per vector");
+
+namespace {
+
+// Time to the nearest exit from every cell, summing Grid::getMoveCost's time of each cell left on
+// the way; INT_MAX where no exit can be reached.
+std::vector<int> exitTimes(const Grid& grid) {
+    int cols = grid.getCols();
+    std::vector<int> time(static_cast<std::size_t>(grid.getRows()) * cols, INT_MAX);
+    using Entry = std::pair<int, int>; // (time, cell)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> frontier;
+    for (const Position& exit : grid.getExitPositions()) {
+        time[exit.row * cols + exit.col] = 0;
+        frontier.push({0, exit.row * cols + exit.col});
+    }
+    while (!frontier.empty()) {
+        auto [t, cell] = frontier.top();
+        frontier.pop();
+        if (t > time[cell]) continue;
+        Position pos = {cell / cols, cell % cols};
+        for (int a = 0; a < NUM_ACTIONS; ++a) {
+            Position prev = grid.getNextPosition(pos, static_cast<Direction>(a));
+            if (!grid.isWalkable(prev.row, prev.col)) continue;
+            int prev_cell = prev.row * cols + prev.col;
+            int prev_time = t + grid.getMoveCost(prev).time;
+            if (prev_time >= time[prev_cell]) continue;
+            time[prev_cell] = prev_time;
+            frontier.push({prev_time, prev_cell});
+        }
+    }
+    return time;
+}
+
+} // namespace
+
+FeatureGrid::FeatureGrid(const Grid& grid)
+    : rows(grid.getRows()), cols(grid.getCols()),
+      data(static_cast<std::size_t>(rows) * cols * NUM_FEATURES * NUM_ACTIONS, 0.0f) {
+    std::vector<int> time_to_exit = exitTimes(grid);
+    auto hazard_fraction = [&](const Position& center, CellType type) {
+        int count = 0;
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int dc = -1; dc <= 1; ++dc) {
+                Position p = {center.row + dr, center.col + dc};
+                if (grid.isValid(p.row, p.col) && grid.getCellType(p) == type) ++count;
+            }
+        }
+        return count / 9.0f;
+    };
+
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            Position pos = {r, c};
+            float* f = &data[static_cast<std::size_t>(cellIndex(pos)) * NUM_FEATURES * NUM_ACTIONS];
+            int here = time_to_exit[cellIndex(pos)];
+            for (int a = 0; a < NUM_ACTIONS; ++a) {
+                Position next = grid.getNextPosition(pos, static_cast<Direction>(a));
+                bool blocked = !grid.isWalkable(next.row, next.col);
+                if (blocked) next = pos;
+                CellType type = grid.getCellType(next);
+                int there = time_to_exit[cellIndex(next)];
+                // Unreachable cells compare as furthest
+                float delta = there < here ? -1.0f : (here < there ? 1.0f : 0.0f);
+
+                f[FEATURE_BIAS * NUM_ACTIONS + a] = 1.0f;
+                f[FEATURE_BLOCKED * NUM_ACTIONS + a] = blocked ? 1.0f : 0.0f;
+                f[FEATURE_EXIT * NUM_ACTIONS + a] = grid.isExit(next.row, next.col) ? 1.0f : 0.0f;
+                f[FEATURE_FIRE * NUM_ACTIONS + a] = type == CellType::FIRE ? 1.0f : 0.0f;
+                f[FEATURE_SMOKE * NUM_ACTIONS + a] = type == CellType::SMOKE ? 1.0f : 0.0f;
+                f[FEATURE_DISTANCE * NUM_ACTIONS + a] = delta;
+                f[FEATURE_FIRE_NEARBY * NUM_ACTIONS + a] = hazard_fraction(next, CellType::FIRE);
+                f[FEATURE_SMOKE_NEARBY * NUM_ACTIONS + a] = hazard_fraction(next, CellType::SMOKE);
+            }
+        }
+    }
+}
+
+LinearQModel::LinearQModel() {
+    std::fill(weights, weights + NUM_FEATURES, 0.0f);
+}
+
+void LinearQModel::evaluate(const float* features, float* q_values) const {
+#ifdef ENMOD_FEATURE_SSE
+    __m128 acc = _mm_setzero_ps();
+    for (int f = 0; f < NUM_FEATURES; ++f) {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(weights[f]), _mm_load_ps(features + f * NUM_ACTIONS)));
+    }
+    _mm_storeu_ps(q_values, acc);
+#else
+    for (int a = 0; a < NUM_ACTIONS; ++a) q_values[a] = 0.0f;
+    for (int f = 0; f < NUM_FEATURES; ++f) {
+        for (int a = 0; a < NUM_ACTIONS; ++a) q_values[a] += weights[f] * features[f * NUM_ACTIONS + a];
+    }
+#endif
+}
+
+int LinearQModel::bestAction(const float* features) const {
+    float q[NUM_ACTIONS];
+    evaluate(features, q);
+    int best = 0;
+    for (int a = 1; a < NUM_ACTIONS; ++a) {
+        if (q[a] > q[best]) best = a;
+    }
+    return best;
+}
+
+void LinearQModel::update(const float* features, int action, float td_error, float learning_rate) {
+    float step = learning_rate * td_error;
+    for (int f = 0; f < NUM_FEATURES; ++f) weights[f] += step * features[f * NUM_ACTIONS + action];
+}
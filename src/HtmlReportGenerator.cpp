@@ -74,9 +74,9 @@ void HtmlReportGenerator::generateSummaryReport(const std::vector<Result>& resul
     });
 
     std::vector<std::string> static_dp_solvers = {"BIDP", "FIDP", "API"};
-    std::vector<std::string> static_rl_solvers = {"QLearning", "SARSA", "ActorCritic"};
+    std::vector<std::string> static_rl_solvers = {"QLearning", "SARSA", "ActorCritic", "FeatureQLearning"};
     std::vector<std::string> dynamic_dp_solvers = {"DynamicBIDPSim", "DynamicFIDPSim", "DynamicAVISim", "DynamicAPISim"};
-    std::vector<std::string> dynamic_rl_solvers = {"DynamicQLearningSim", "DynamicSARSASim", "DynamicActorCriticSim"};
+    std::vector<std::string> dynamic_rl_solvers = {"DynamicQLearningSim", "DynamicSARSASim", "DynamicActorCriticSim", "DynamicFeatureQSim"};
     std::vector<std::string> hybrid_solvers = {"HybridDPRLSim", "AdaptiveCostSim", "InterlacedSim", "HierarchicalSim", "PolicyBlendingSim"};
 
     report_file << "<table>\n";
@@ -134,5 +134,24 @@ void HtmlReportGenerator::generateSummaryReport(const std::vector<Result>& resul
     write_solver_rows(hybrid_solvers);
 
     report_file << "</tbody></table>\n";
+
+    if (Profiler::enabled) {
+        report_file << "<h2>Profile</h2>\n<table>\n<thead><tr><th>Scenario</th><th>Algorithm</th>";
+        for (int p = 0; p < NUM_PROFILE_PHASES; ++p) report_file << "<th>" << Profiler::phaseName(p) << " (ms)</th>";
+        for (int c = 0; c < NUM_PROFILE_COUNTERS; ++c) report_file << "<th>" << Profiler::counterName(c) << "</th>";
+        for (int h = 0; h < NUM_HARDWARE_COUNTERS; ++h) report_file << "<th>" << Profiler::hardwareName(h) << "</th>";
+        report_file << "</tr></thead>\n<tbody>";
+        for (const auto& res : results) {
+            report_file << "<tr><td>" << res.scenario_name << "</td><td>" << res.solver_name << "</td>";
+            for (int p = 0; p < NUM_PROFILE_PHASES; ++p) report_file << "<td>" << res.profile.phase_ms[p] << "</td>";
+            for (int c = 0; c < NUM_PROFILE_COUNTERS; ++c) report_file << "<td>" << res.profile.counters[c] << "</td>";
+            for (int h = 0; h < NUM_HARDWARE_COUNTERS; ++h) {
+                if (res.profile.has_hardware) report_file << "<td>" << res.profile.hardware[h] << "</td>";
+                else report_file << "<td>N/A</td>";
+            }
+            report_file << "</tr>\n";
+        }
+        report_file << "</tbody></table>\n";
+    }
     writeHtmlFooter(report_file);
 }
\ No newline at end of file
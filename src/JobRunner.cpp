@@ -0,0 +1,58 @@
+#include "enmod/JobRunner.h"
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+JobRunner::JobRunner(int num_workers) : num_workers(num_workers) {
+    if (this->num_workers <= 0) {
+        this->num_workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+bool JobRunner::popOwn(WorkQueue& queue, std::size_t& job) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+    job = queue.jobs.front();
+    queue.jobs.pop_front();
+    return true;
+}
+
+bool JobRunner::steal(WorkQueue& queue, std::size_t& job) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+    job = queue.jobs.back();
+    queue.jobs.pop_back();
+    return true;
+}
+
+void JobRunner::run(const std::vector<std::function<void()>>& jobs) {
+    if (jobs.empty()) return;
+    int workers = static_cast<int>(std::min<std::size_t>(num_workers, jobs.size()));
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    for (int i = 0; i < workers; ++i) queues.push_back(std::make_unique<WorkQueue>());
+    for (std::size_t j = 0; j < jobs.size(); ++j) queues[j % workers]->jobs.push_back(j);
+
+    // No job is ever enqueued after this point, so a worker that finds every queue empty is done.
+    std::vector<std::exception_ptr> errors(jobs.size());
+    auto work = [&](int self) {
+        std::size_t job;
+        for (;;) {
+            bool found = popOwn(*queues[self], job);
+            for (int k = 1; !found && k < workers; ++k) found = steal(*queues[(self + k) % workers], job);
+            if (!found) return;
+            try {
+                jobs[job]();
+            } catch (...) {
+                errors[job] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < workers; ++i) threads.emplace_back(work, i);
+    work(0);
+    for (auto& thread : threads) thread.join();
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
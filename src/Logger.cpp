@@ -9,8 +9,10 @@
 #endif
 
 std::ofstream Logger::log_file;
+std::mutex Logger::log_mutex;
 
 void Logger::init(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(log_mutex);
     log_file.open(filename, std::ios_base::out | std::ios_base::app);
     if (!log_file.is_open()) {
         std::cerr << "FATAL: Could not open log file: " << filename << std::endl;
@@ -18,6 +20,7 @@ void Logger::init(const std::string& filename) {
 }
 
 void Logger::log(LogLevel level, const std::string& message) {
+    std::lock_guard<std::mutex> lock(log_mutex);
     if (!log_file.is_open()) return;
 
     auto now = std::chrono::system_clock::now();
@@ -38,6 +41,7 @@ void Logger::log(LogLevel level, const std::string& message) {
 }
 
 void Logger::close() {
+    std::lock_guard<std::mutex> lock(log_mutex);
     if (log_file.is_open()) {
         log_file.close();
     }
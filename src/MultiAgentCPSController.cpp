@@ -1,80 +1,281 @@
 #include "enmod/MultiAgentCPSController.h"
 #include "enmod/Logger.h"
-#include <fstream>
+#include "enmod/RLSolver.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
 #include <iostream>
-#include <filesystem>
+#include <stdexcept>
 #include <string>
 
-MultiAgentCPSController::MultiAgentCPSController(const json& initial_config, const std::string& report_path, int num_agents)
+namespace {
+
+// Agents per planning job: below this, handing a slice to another thread costs more than it saves.
+constexpr std::size_t MIN_AGENTS_PER_JOB = 256;
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+MultiAgentCPSController::MultiAgentCPSController(const json& initial_config, const std::string& report_path, int num_agents, int num_workers)
     : master_grid(initial_config),
+      solver(std::make_unique<HybridDPRLSolver>(master_grid)),
       report_generator(report_path + "/multi_agent_report.html"),
-      report_path(report_path) {
+      report_path(report_path),
+      transport(AgentTransport::fromEnvironment(report_path + "/agent_io", FileLayout::LOG)),
+      session(solver->getRLPolicy()),
+      exit_assignment(master_grid),
+      workers(num_workers) {
+    placeAgents(num_agents, initial_config);
+    agent_exits.assign(agents.size(), -1);
+}
 
-    std::filesystem::create_directory(report_path + "/agent_io");
+// Agents fill the walkable cells nearest the start in breadth-first order, one agent per cell,
+// so any crowd the building can hold is seated without overlaps.
+void MultiAgentCPSController::placeAgents(int num_agents, const json& initial_config) {
+    auto config = std::make_shared<const json>(initial_config); // One copy for every agent's feed
+    std::vector<char> seen(static_cast<std::size_t>(master_grid.getRows()) * master_grid.getCols(), 0);
+    auto visit = [&](const Position& pos) {
+        if (!master_grid.isWalkable(pos.row, pos.col)) return false;
+        char& flag = seen[static_cast<std::size_t>(pos.row) * master_grid.getCols() + pos.col];
+        if (flag) return false;
+        flag = 1;
+        return true;
+    };
 
-    // Initialize agents safely within the grid boundaries
+    std::deque<Position> frontier;
     Position start_pos = master_grid.getStartPosition();
-    for (int i = 0; i < num_agents; ++i) {
-        Position agent_pos = {start_pos.row + i, start_pos.col};
-
-        // If the calculated position is invalid or blocked, find a new one.
-        while (!master_grid.isWalkable(agent_pos.row, agent_pos.col)) {
-            agent_pos.col++; // Try the next column
-            if (!master_grid.isValid(agent_pos.row, agent_pos.col)) {
-                agent_pos.col--; // Move back if we went out of bounds
-                agent_pos.row++; // Try the next row
+    if (visit(start_pos)) frontier.push_back(start_pos);
+    static const Direction dirs[] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+    while (!frontier.empty() && static_cast<int>(agents.size()) < num_agents) {
+        Position agent_pos = frontier.front();
+        frontier.pop_front();
+        for (Direction dir : dirs) {
+            Position neighbor = master_grid.getNextPosition(agent_pos, dir);
+            if (visit(neighbor)) frontier.push_back(neighbor);
+        }
+        if (master_grid.isExit(agent_pos.row, agent_pos.col)) continue;
+
+        agents.push_back({"agent_" + std::to_string(agents.size()), agent_pos});
+        environment_feeds.emplace(agents.back().id, EnvironmentDeltaEncoder(config));
+    }
+
+    if (static_cast<int>(agents.size()) < num_agents) {
+        Logger::log(LogLevel::WARN, "Only " + std::to_string(agents.size()) + " of " + std::to_string(num_agents) +
+                    " agents fit in the cells reachable from the start of " + master_grid.getName() + ".");
+    }
+}
+
+// The agent's half of a round trip: it reports its position and new hazards, and the server
+// merges them into the shared session. Returns false if the server needs a snapshot first.
+bool MultiAgentCPSController::observe(int timestep, const Agent& agent) {
+    AgentObservation observation;
+    if (!transport->sendObservation({agent.id, timestep, agent.position, environment_feeds.at(agent.id).next()}) ||
+        !transport->receiveObservation(observation)) {
+        throw std::runtime_error("CPS server received no observation from " + agent.id + " at timestep " + std::to_string(timestep));
+    }
+
+    return session.apply(observation.environment, observation.agent_id);
+}
+
+// The server's reply to one agent, and the move the agent then carries out.
+Direction MultiAgentCPSController::command(int timestep, const Agent& agent, Direction move, bool resync) {
+    AgentCommand reply = {agent.id, timestep, move, resync};
+    AgentCommand received;
+    if (!transport->sendCommand(reply) || !transport->receiveCommand(received)) {
+        throw std::runtime_error(agent.id + " received no command at timestep " + std::to_string(timestep));
+    }
+    if (received.resync) {
+        Logger::log(LogLevel::WARN, agent.id + " at timestep " + std::to_string(timestep) + ": Server lost environment updates; sending a snapshot next.");
+        environment_feeds.at(agent.id).requestSnapshot();
+    }
+    return received.move;
+}
+
+void MultiAgentCPSController::forEachActive(const std::function<void(std::size_t, std::size_t)>& body) {
+    std::size_t slices = std::min<std::size_t>(static_cast<std::size_t>(workers.getNumWorkers()) * 4,
+                                               (active.size() + MIN_AGENTS_PER_JOB - 1) / MIN_AGENTS_PER_JOB);
+    if (slices <= 1) {
+        body(0, active.size());
+        return;
+    }
+    std::vector<std::function<void()>> jobs;
+    for (std::size_t s = 0; s < slices; ++s) {
+        std::size_t begin = active.size() * s / slices;
+        std::size_t end = active.size() * (s + 1) / slices;
+        jobs.push_back([&body, begin, end]() { body(begin, end); });
+    }
+    workers.run(jobs);
+}
+
+// Re-balances the crowd over the exits from every active agent's walk to each of them. Agents
+// the session cannot plan for this step keep their exit.
+void MultiAgentCPSController::assignExits() {
+    const int num_exits = session.getNumExits();
+    exit_distances.resize(active.size() * num_exits);
+    forEachActive([this, num_exits](std::size_t begin, std::size_t end) {
+        for (std::size_t k = begin; k < end; ++k) {
+            for (int e = 0; e < num_exits; ++e) {
+                exit_distances[k * num_exits + e] = synced[k] ? session.exitDistance(agents[active[k]].position, e) : MAX_COST;
             }
         }
+    });
+
+    exits.resize(active.size());
+    for (std::size_t k = 0; k < active.size(); ++k) exits[k] = agent_exits[active[k]];
+    exit_assignment.solve(exit_distances, exits);
+    for (std::size_t k = 0; k < active.size(); ++k) {
+        if (synced[k]) agent_exits[active[k]] = exits[k];
+    }
+}
 
-        if (!master_grid.isValid(agent_pos.row, agent_pos.col)) {
-            Logger::log(LogLevel::ERROR, "Could not place agent " + std::to_string(i) + " within grid bounds.");
-            continue;
+// Fills moves[] for the active agents. Threat assessment and exit assignment run on the worker
+// threads and only read the session; the agents then plan in order through the cooperative
+// planner, each around the space-time reservations of the ones before it, so no two agents end
+// a step on one cell or swap places. With several exits each agent heads for the exit it was
+// assigned, rather than the nearest one.
+void MultiAgentCPSController::decideMoves() {
+    if (!session.isReady()) { // Nobody has sent a snapshot yet: there is nothing to plan on
+        std::fill(moves.begin(), moves.end(), Direction::STAY);
+        return;
+    }
+
+    forEachActive([this](std::size_t begin, std::size_t end) {
+        for (std::size_t k = begin; k < end; ++k) {
+            if (synced[k]) modes[k] = session.assessMode(agents[active[k]].position);
         }
+    });
 
-        agents.push_back({"agent_" + std::to_string(i), agent_pos});
+    // Cost fields are rebuilt here, on this thread, before anyone reads them
+    bool needed[3] = {false, false, false};
+    for (std::size_t k = 0; k < active.size(); ++k) {
+        if (synced[k] && modes[k] != EvacuationMode::PANIC) needed[static_cast<int>(modes[k])] = true;
+    }
+    bool by_exit = session.isReady() && session.getNumExits() > 1;
+    if (by_exit) {
+        session.prepareExitFields(EvacuationMode::NORMAL); // Walking distances for the assignment
+        if (needed[static_cast<int>(EvacuationMode::ALERT)]) session.prepareExitFields(EvacuationMode::ALERT);
+        assignExits();
+    } else {
+        for (EvacuationMode field_mode : {EvacuationMode::NORMAL, EvacuationMode::ALERT}) {
+            if (needed[static_cast<int>(field_mode)]) session.prepareField(field_mode);
+        }
     }
 
-    solver = std::make_unique<HybridDPRLSolver>(master_grid);
+    // Agents with fixed moves go first, then the rest nearest to their exit first, so that those
+    // queueing behind someone plan after the agent ahead has said where it goes
+    positions.resize(active.size());
+    order.clear();
+    for (std::size_t k = 0; k < active.size(); ++k) {
+        positions[k] = agents[active[k]].position;
+        int remaining = 0;
+        if (synced[k] && modes[k] != EvacuationMode::PANIC && (!by_exit || exits[k] >= 0)) {
+            remaining = session.getField(modes[k], by_exit ? exits[k] : -1)[positions[k].row][positions[k].col].distance;
+        }
+        order.push_back({remaining, static_cast<int>(k)});
+    }
+    std::sort(order.begin(), order.end());
+    planner.beginRound(session.getGrid(), session.getVersion(), positions);
+    for (const auto& entry : order) {
+        int agent = entry.second;
+        std::size_t k = static_cast<std::size_t>(agent);
+        if (!synced[k]) {
+            planner.hold(agent); // Hold position until a snapshot brings the session back in step
+            moves[k] = Direction::STAY;
+        } else if (modes[k] == EvacuationMode::PANIC) {
+            moves[k] = planner.claim(agent, session.panicMove(positions[k]));
+        } else if (by_exit && exits[k] < 0) {
+            planner.hold(agent); // No exit can be reached from here
+            moves[k] = Direction::STAY;
+        } else {
+            Cost::current_mode = modes[k];
+            moves[k] = planner.plan(agent, session.getField(modes[k], by_exit ? exits[k] : -1));
+        }
+    }
 }
 
-void MultiAgentCPSController::write_input_file(int timestep, const Agent& agent) {
-    json input_data;
-    input_data["agent_id"] = agent.id;
-    input_data["timestep"] = timestep;
-    input_data["current_position"] = {
-        {"row", agent.position.row},
-        {"col", agent.position.col}
-    };
-    input_data["environment_update"] = master_grid.getConfig();
+void MultiAgentCPSController::recordReplay(const std::string& path) {
+    std::vector<Position> starts;
+    for (const auto& agent : agents) starts.push_back(agent.position);
+    replay = std::make_unique<ReplayRecorder>(path, master_grid.getConfig(), RLSolver::run_seed, starts);
+}
+
+void MultiAgentCPSController::applyEvents(int timestep) {
+    const json& config = master_grid.getConfig();
+    auto events = config.find("dynamic_events");
+    if (events == config.end()) return;
+    for (std::size_t i = 0; i < events->size(); ++i) {
+        const json& event_cfg = (*events)[i];
+        if (event_cfg.value("time_step", -1) == timestep) {
+            master_grid.addHazard(event_cfg);
+            for (auto& feed : environment_feeds) feed.second.recordFire(event_cfg);
+            if (replay) replay->recordHazard(timestep, i);
+        }
+    }
+}
+
+bool MultiAgentCPSController::advance(int timestep) {
+    active.clear();
+    for (std::size_t i = 0; i < agents.size(); ++i) {
+        if (!master_grid.isExit(agents[i].position.row, agents[i].position.col)) active.push_back(i);
+    }
+    if (active.empty()) return true;
+    synced.resize(active.size());
+    modes.resize(active.size());
+    moves.resize(active.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t k = 0; k < active.size(); ++k) synced[k] = observe(timestep, agents[active[k]]);
+    stats.exchange_ms += millisecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    decideMoves();
+    stats.decision_ms += millisecondsSince(start);
+
+    if (replay) {
+        replay_positions.resize(agents.size());
+        for (std::size_t i = 0; i < agents.size(); ++i) replay_positions[i] = agents[i].position;
+        replay_moves.assign(agents.size(), Direction::STAY);
+        replay_modes.assign(agents.size(), EvacuationMode::NORMAL);
+    }
 
-    std::ofstream o(report_path + "/agent_io/" + agent.id + "_input_t" + std::to_string(timestep) + ".json");
-    o << std::setw(4) << input_data << std::endl;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t k = 0; k < active.size(); ++k) {
+        Agent& agent = agents[active[k]];
+        Direction received_move = command(timestep, agent, moves[k], !synced[k]);
+        agent.position = master_grid.getNextPosition(agent.position, received_move);
+        if (replay) {
+            replay_moves[active[k]] = received_move;
+            replay_modes[active[k]] = modes[k];
+        }
+    }
+    stats.exchange_ms += millisecondsSince(start);
+    if (replay) replay->recordStep(timestep, replay_positions, replay_moves, replay_modes);
+
+    ++stats.timesteps;
+    stats.decisions += static_cast<long long>(active.size());
+    return false;
 }
 
-Direction MultiAgentCPSController::read_output_file(int timestep, const Agent& agent) {
-    std::ifstream i(report_path + "/agent_io/" + agent.id + "_output_t" + std::to_string(timestep) + ".json");
-    json output_data;
-    i >> output_data;
-
-    std::string move = output_data.at("next_move");
-    if (move == "UP") return Direction::UP;
-    if (move == "DOWN") return Direction::DOWN;
-    if (move == "LEFT") return Direction::LEFT;
-    if (move == "RIGHT") return Direction::RIGHT;
-    return Direction::STAY;
+bool MultiAgentCPSController::step(int timestep) {
+    applyEvents(timestep);
+    return advance(timestep);
 }
 
 void MultiAgentCPSController::run_simulation() {
     std::cout << "\n===== Starting Real-Time Multi-Agent CPS Simulation for " << master_grid.getName() << " =====\n";
+    try {
+        recordReplay(report_path + "/multi_agent.replay");
+    } catch (const std::exception& e) {
+        Logger::log(LogLevel::WARN, std::string(e.what()) + "; running without a replay.");
+    }
 
-    for (int t = 0; t < 2 * (master_grid.getRows() * master_grid.getCols()); ++t) {
+    int t = 0;
+    for (; t < 2 * (master_grid.getRows() * master_grid.getCols()); ++t) {
         std::cout << "Timestep " << t << std::endl;
-
-        for (const auto& event_cfg : master_grid.getConfig().value("dynamic_events", json::array())) {
-            if (event_cfg.value("time_step", -1) == t) {
-                master_grid.addHazard(event_cfg);
-            }
-        }
+        applyEvents(t);
 
         std::vector<Position> agent_positions;
         for (const auto& agent : agents) {
@@ -82,40 +283,7 @@ void MultiAgentCPSController::run_simulation() {
         }
         report_generator.add_timestep(t, master_grid, agent_positions);
 
-        bool all_exited = true;
-        for (auto& agent : agents) {
-            if (master_grid.isExit(agent.position.row, agent.position.col)) {
-                continue;
-            }
-            all_exited = false;
-
-            write_input_file(t, agent);
-
-            Grid agent_grid = master_grid;
-            for (const auto& other_agent : agents) {
-                if (agent.id != other_agent.id) {
-                    agent_grid.setCellUnwalkable(other_agent.position);
-                }
-            }
-            Direction next_move = solver->getNextMove(agent.position, agent_grid);
-
-            json output_data;
-            output_data["agent_id"] = agent.id;
-            std::string move_str = "STAY";
-            if (next_move == Direction::UP) move_str = "UP";
-            else if (next_move == Direction::DOWN) move_str = "DOWN";
-            else if (next_move == Direction::LEFT) move_str = "LEFT";
-            else if (next_move == Direction::RIGHT) move_str = "RIGHT";
-            output_data["next_move"] = move_str;
-
-            std::ofstream o(report_path + "/agent_io/" + agent.id + "_output_t" + std::to_string(t) + ".json");
-            o << std::setw(4) << output_data << std::endl;
-
-            Direction received_move = read_output_file(t, agent);
-            agent.position = master_grid.getNextPosition(agent.position, received_move);
-        }
-
-        if (all_exited) {
+        if (advance(t)) {
             std::cout << "SUCCESS: All agents reached the exit." << std::endl;
             Logger::log(LogLevel::INFO, "SUCCESS: All agents reached the exit.");
             break;
@@ -123,6 +291,21 @@ void MultiAgentCPSController::run_simulation() {
     }
 
     report_generator.finalize_report();
+    if (replay) {
+        // Steps hold positions from before their moves, so the state the run ended in needs one
+        // more: everyone staying put at t, the timestep that was not carried out
+        replay_positions.resize(agents.size());
+        for (std::size_t i = 0; i < agents.size(); ++i) replay_positions[i] = agents[i].position;
+        replay_moves.assign(agents.size(), Direction::STAY);
+        replay_modes.assign(agents.size(), EvacuationMode::NORMAL);
+        replay->recordStep(t, replay_positions, replay_moves, replay_modes);
+        replay->flush();
+    }
     std::cout << "\nMulti-agent simulation for " << master_grid.getName() << " complete. Report generated at "
               << report_path << "/multi_agent_report.html\n";
-}
\ No newline at end of file
+    if (stats.decisions > 0) {
+        Logger::log(LogLevel::INFO, master_grid.getName() + ": " + std::to_string(stats.decisions) + " agent decisions on " +
+                    std::to_string(workers.getNumWorkers()) + " workers, " + std::to_string(stats.decision_ms * 1000.0 / stats.decisions) +
+                    " us each, " + std::to_string(stats.exchange_ms * 1000.0 / stats.decisions) + " us transport per decision.");
+    }
+}
@@ -19,20 +19,22 @@ void MultiAgentReportGenerator::finalize_report() {
 }
 
 std::string MultiAgentReportGenerator::toHtmlStringWithMultipleAgents(const Grid& grid, const std::vector<Position>& agent_positions) const {
+    // First agent on each cell, so a crowd costs one pass over it rather than one per cell
+    std::vector<int> occupant(static_cast<std::size_t>(grid.getRows()) * grid.getCols(), -1);
+    for (size_t i = agent_positions.size(); i-- > 0;) {
+        const Position& pos = agent_positions[i];
+        if (grid.isValid(pos.row, pos.col)) occupant[static_cast<std::size_t>(pos.row) * grid.getCols() + pos.col] = static_cast<int>(i);
+    }
+
     std::stringstream ss;
     ss << "<table class='grid-table'><tbody>";
     for(int r = 0; r < grid.getRows(); ++r){
         ss << "<tr>";
         for(int c = 0; c < grid.getCols(); ++c){
             std::string content = "";
-            bool agent_found = false;
-            for(size_t i = 0; i < agent_positions.size(); ++i) {
-                if (r == agent_positions[i].row && c == agent_positions[i].col) {
-                    content = "A" + std::to_string(i + 1);
-                    agent_found = true;
-                    break;
-                }
-            }
+            int agent_index = occupant[static_cast<std::size_t>(r) * grid.getCols() + c];
+            bool agent_found = agent_index >= 0;
+            if (agent_found) content = "A" + std::to_string(agent_index + 1);
 
             std::string class_name;
             if (!agent_found) {
@@ -0,0 +1,87 @@
+#include "enmod/ParallelTrainer.h"
+#include "enmod/Logger.h"
+#include <thread>
+#include <chrono>
+#include <exception>
+#include <algorithm>
+
+ParallelTrainer::ParallelTrainer(int num_workers, int sync_interval)
+    : num_workers(num_workers), sync_interval(std::max(1, sync_interval)) {
+    if (this->num_workers <= 0) {
+        this->num_workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+TrainingStats ParallelTrainer::train(RLSolver& solver, const TrainingOptions& options) {
+    TrainingStats stats;
+    stats.workers = num_workers;
+    auto start_time = std::chrono::steady_clock::now();
+
+    std::uint64_t seed_state = solver.getRng()();
+    std::vector<int> previous = solver.greedyActions();
+    int stable_rounds = 0;
+
+    while (stats.episodes < options.max_episodes) {
+        int round_episodes = std::min(options.max_episodes - stats.episodes, sync_interval * num_workers);
+        int round_workers = std::min(num_workers, round_episodes);
+        std::vector<std::unique_ptr<RLSolver>> workers;
+        for (int i = 0; i < round_workers; ++i) {
+            workers.push_back(solver.clone());
+            workers.back()->seed(splitMix64(seed_state));
+        }
+
+        std::vector<TrainingSummary> summaries(round_workers);
+        std::vector<std::exception_ptr> errors(round_workers);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < round_workers; ++i) {
+            threads.emplace_back([&, i]() {
+                try {
+                    TrainingOptions share;
+                    share.max_episodes = round_episodes / round_workers + (i < round_episodes % round_workers ? 1 : 0);
+                    share.check_interval = 0;
+                    summaries[i] = workers[i]->trainUntilConverged(share);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        for (const auto& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+
+        std::vector<const RLSolver*> merged;
+        for (const auto& worker : workers) merged.push_back(worker.get());
+        double merge_delta = solver.mergeWorkers(merged);
+        stats.merge_deltas.push_back(merge_delta);
+        stats.episodes += round_episodes;
+
+        TrainingSummary& round = stats.last_round;
+        round = TrainingSummary();
+        for (const auto& summary : summaries) {
+            round.mean_steps += summary.mean_steps * summary.episodes / round_episodes;
+            round.mean_return += summary.mean_return * summary.episodes / round_episodes;
+            round.exit_rate += summary.exit_rate * summary.episodes / round_episodes;
+        }
+        round.episodes = round_episodes;
+        round.max_delta_q = merge_delta;
+
+        if (options.check_interval <= 0) continue;
+        std::vector<int> current = solver.greedyActions();
+        bool stable = current == previous && round.exit_rate > 0.0 &&
+                      (options.delta_tolerance <= 0.0 || merge_delta <= options.delta_tolerance) &&
+                      (!options.require_greedy_exit || solver.greedyReachesExit());
+        stable_rounds = stable ? stable_rounds + 1 : 0;
+        if (stable_rounds >= options.patience) {
+            stats.converged = true;
+            break;
+        }
+        previous = std::move(current);
+    }
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    stats.episodes_per_second = stats.seconds > 0 ? stats.episodes / stats.seconds : 0.0;
+    Logger::log(LogLevel::INFO, solver.getName() + ": trained " + std::to_string(stats.episodes) + " episodes on " +
+                std::to_string(num_workers) + " workers (" + std::to_string(static_cast<long long>(stats.episodes_per_second)) + " episodes/sec).");
+    return stats;
+}
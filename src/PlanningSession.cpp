@@ -0,0 +1,67 @@
+#include "enmod/PlanningSession.h"
+#include "enmod/DynamicSimulation.h"
+#include "enmod/StepPolicies.h"
+
+PlanningSession::PlanningSession(const QLearningSolver& rl_policy) : rl_policy(rl_policy) {}
+
+PlanningSession::PlanningSession(const Grid& grid, const QLearningSolver& rl_policy) : rl_policy(rl_policy) {
+    environment.reset(grid);
+}
+
+bool PlanningSession::apply(const EnvironmentUpdate& update, const std::string& sender) {
+    // Fields whose version no longer matches the environment's are rebuilt when next used
+    return environment.apply(update, sender);
+}
+
+const std::vector<std::vector<Cost>>& PlanningSession::costField(EvacuationMode field_mode) {
+    int m = static_cast<int>(field_mode);
+    if (!fields[m] || field_versions[m] != environment.getVersion()) {
+        if (!fields[m]) fields[m] = std::make_unique<BIDP>(environment.getGrid());
+        fields[m]->run(); // Compares Costs under Cost::current_mode, which the caller has set to field_mode
+        field_versions[m] = environment.getVersion();
+        ++field_rebuilds;
+    }
+    return fields[m]->getCostMap();
+}
+
+void PlanningSession::prepareField(EvacuationMode field_mode) {
+    Cost::current_mode = field_mode;
+    costField(field_mode);
+}
+
+void PlanningSession::prepareExitFields(EvacuationMode field_mode) {
+    int m = static_cast<int>(field_mode);
+    const Grid& grid = environment.getGrid();
+    if (!exit_fields[m].empty() && exit_field_versions[m] == environment.getVersion()) return;
+    if (exit_fields[m].empty()) {
+        for (const auto& exit_pos : grid.getExitPositions()) exit_fields[m].push_back(std::make_unique<BIDP>(grid, std::vector<Position>{exit_pos}));
+    }
+    Cost::current_mode = field_mode;
+    for (auto& field : exit_fields[m]) field->run();
+    exit_field_versions[m] = environment.getVersion();
+    field_rebuilds += static_cast<int>(exit_fields[m].size());
+}
+
+const std::vector<std::vector<Cost>>& PlanningSession::getField(EvacuationMode field_mode, int exit) const {
+    int m = static_cast<int>(field_mode);
+    return exit >= 0 ? exit_fields[m][exit]->getCostMap() : fields[m]->getCostMap();
+}
+
+int PlanningSession::exitDistance(const Position& pos, int exit) const {
+    return exit_fields[static_cast<int>(EvacuationMode::NORMAL)][exit]->getCostMap()[pos.row][pos.col].distance;
+}
+
+EvacuationMode PlanningSession::assessMode(const Position& current_pos) const {
+    return assessThreat(current_pos, environment.getGrid());
+}
+
+Direction PlanningSession::panicMove(const Position& current_pos) const {
+    return rl_policy.greedyAction(current_pos);
+}
+
+Direction PlanningSession::nextMove(const Position& current_pos) {
+    mode = assessMode(current_pos);
+    Cost::current_mode = mode;
+    if (mode == EvacuationMode::PANIC) return panicMove(current_pos);
+    return descentDirection(environment.getGrid(), costField(mode), current_pos);
+}
@@ -0,0 +1,169 @@
+#include "enmod/PolicyArtifact.h"
+#include "enmod/Logger.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <iomanip>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char ARTIFACT_MAGIC[8] = {'E', 'N', 'M', 'O', 'D', 'Q', 'T', '\0'};
+
+std::size_t valueBytes(int rows, int cols) {
+    return static_cast<std::size_t>(rows) * cols * NUM_ACTIONS * sizeof(QValue);
+}
+
+// Validates a complete artifact image and copies it into the table.
+bool decode(const unsigned char* bytes, std::size_t size, std::uint64_t grid_hash, std::uint64_t training_hash, QTable& table) {
+    if (size < sizeof(PolicyArtifactHeader)) return false;
+    PolicyArtifactHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+
+    if (std::memcmp(header.magic, ARTIFACT_MAGIC, sizeof(ARTIFACT_MAGIC)) != 0) return false;
+    if (header.version != PolicyArtifact::FORMAT_VERSION) return false;
+    if (header.value_size != sizeof(QValue) || header.num_actions != NUM_ACTIONS) return false;
+    if (header.grid_hash != grid_hash || header.training_hash != training_hash) return false;
+    if (header.rows <= 0 || header.cols <= 0) return false;
+
+    std::size_t q_bytes = valueBytes(header.rows, header.cols);
+    std::size_t cells = static_cast<std::size_t>(header.rows) * header.cols;
+    if (size != sizeof(header) + q_bytes + cells) return false;
+
+    const unsigned char* payload = bytes + sizeof(header);
+    if (PolicyArtifact::hashBytes(payload, q_bytes + cells) != header.payload_hash) return false;
+
+    table.reset(header.rows, header.cols);
+    std::memcpy(table.values(0), payload, q_bytes);
+    const unsigned char* visited = payload + q_bytes;
+    for (std::size_t cell = 0; cell < cells; ++cell) {
+        if (visited[cell]) table.markVisited(static_cast<int>(cell));
+    }
+    return true;
+}
+
+} // namespace
+
+std::uint64_t PolicyArtifact::hashBytes(const void* data, std::size_t size, std::uint64_t hash) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+std::uint64_t PolicyArtifact::gridHash(const Grid& grid) {
+    std::int32_t dims[2] = {grid.getRows(), grid.getCols()};
+    std::uint64_t hash = hashBytes(dims, sizeof(dims));
+    for (int r = 0; r < grid.getRows(); ++r) {
+        for (int c = 0; c < grid.getCols(); ++c) {
+            unsigned char type = static_cast<unsigned char>(grid.getCellType({r, c}));
+            hash = hashBytes(&type, 1, hash);
+        }
+    }
+    Position start = grid.getStartPosition();
+    std::int32_t start_cell[2] = {start.row, start.col};
+    hash = hashBytes(start_cell, sizeof(start_cell), hash);
+    for (const auto& exit : grid.getExitPositions()) {
+        std::int32_t exit_cell[2] = {exit.row, exit.col};
+        hash = hashBytes(exit_cell, sizeof(exit_cell), hash);
+    }
+    return hash;
+}
+
+std::string PolicyArtifact::cachePath(const std::string& solver_name, const Grid& grid, std::uint64_t training_hash) {
+    std::ostringstream path;
+    path << cache_directory << "/" << solver_name << "_" << std::hex << std::setfill('0') << std::setw(16) << gridHash(grid)
+         << "_" << std::setw(16) << training_hash << ".qtab";
+    return path.str();
+}
+
+bool PolicyArtifact::save(const std::string& path, const QTable& table, std::uint64_t grid_hash, std::uint64_t training_hash) {
+    std::size_t q_bytes = valueBytes(table.getRows(), table.getCols());
+    std::size_t cells = static_cast<std::size_t>(table.numCells());
+
+    std::vector<unsigned char> payload(q_bytes + cells);
+    std::memcpy(payload.data(), table.values(0), q_bytes);
+    for (std::size_t cell = 0; cell < cells; ++cell) {
+        payload[q_bytes + cell] = table.isVisited(static_cast<int>(cell)) ? 1 : 0;
+    }
+
+    PolicyArtifactHeader header = {};
+    std::memcpy(header.magic, ARTIFACT_MAGIC, sizeof(ARTIFACT_MAGIC));
+    header.version = FORMAT_VERSION;
+    header.value_size = sizeof(QValue);
+    header.rows = table.getRows();
+    header.cols = table.getCols();
+    header.num_actions = NUM_ACTIONS;
+    header.grid_hash = grid_hash;
+    header.payload_hash = hashBytes(payload.data(), payload.size());
+    header.training_hash = training_hash;
+
+    std::error_code ec;
+    std::filesystem::path target(path);
+    if (target.has_parent_path()) std::filesystem::create_directories(target.parent_path(), ec);
+
+    // Write next to the target and rename, so concurrent readers never see a partial file. The
+    // temporary name is per thread because two solvers may save the same table concurrently.
+    std::ostringstream temp_name;
+    temp_name << path << ".tmp." << std::this_thread::get_id();
+    std::string temp_path = temp_name.str();
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            Logger::log(LogLevel::WARN, "Could not write policy artifact " + temp_path);
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        if (!out) {
+            Logger::log(LogLevel::WARN, "Could not write policy artifact " + temp_path);
+            return false;
+        }
+    }
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        Logger::log(LogLevel::WARN, "Could not store policy artifact " + path);
+        return false;
+    }
+    return true;
+}
+
+bool PolicyArtifact::load(const std::string& path, std::uint64_t grid_hash, std::uint64_t training_hash, QTable& table) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    std::size_t size = static_cast<std::size_t>(info.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+
+    bool ok = decode(static_cast<const unsigned char*>(mapped), size, grid_hash, training_hash, table);
+    ::munmap(mapped, size);
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    std::vector<unsigned char> bytes(static_cast<std::size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    bool ok = in && decode(bytes.data(), bytes.size(), grid_hash, training_hash, table);
+#endif
+    if (!ok) Logger::log(LogLevel::WARN, "Ignoring stale or corrupt policy artifact " + path);
+    return ok;
+}
@@ -0,0 +1,90 @@
+#include "enmod/Profiler.h"
+
+#if defined(ENMOD_ENABLE_PROFILING) && defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#define ENMOD_PERF_EVENTS 1
+#endif
+
+ProfileData Profiler::take() {
+    ProfileData result = data;
+    data = ProfileData();
+    return result;
+}
+
+const char* Profiler::phaseName(int phase) {
+    static const char* names[NUM_PROFILE_PHASES] = {"Planner setup", "Planning (Dijkstra/DP)", "Neighbour scan",
+                                                    "History recording", "RL training", "Report rendering"};
+    return names[phase];
+}
+
+const char* Profiler::counterName(int counter) {
+    static const char* names[NUM_PROFILE_COUNTERS] = {"Heap pushes", "Heap pops", "Relaxations",
+                                                      "Sweeps", "Episodes", "Simulation steps"};
+    return names[counter];
+}
+
+const char* Profiler::hardwareName(int counter) {
+    static const char* names[NUM_HARDWARE_COUNTERS] = {"Cycles", "Cache misses", "Branch misses"};
+    return names[counter];
+}
+
+#ifdef ENMOD_PERF_EVENTS
+namespace {
+
+int openCounter(std::uint64_t config, int group_fd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = group_fd == -1 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    // This thread only, on whichever CPU it runs
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+} // namespace
+#endif
+
+HardwareCounters::HardwareCounters() {
+#ifdef ENMOD_PERF_EVENTS
+    static const std::uint64_t configs[NUM_HARDWARE_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES,
+                                                                 PERF_COUNT_HW_BRANCH_MISSES};
+    fds[HW_CYCLES] = openCounter(configs[HW_CYCLES], -1);
+    if (fds[HW_CYCLES] < 0) return;
+    for (int i = 1; i < NUM_HARDWARE_COUNTERS; ++i) fds[i] = openCounter(configs[i], fds[HW_CYCLES]);
+    ioctl(fds[HW_CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds[HW_CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+HardwareCounters::~HardwareCounters() {
+#ifdef ENMOD_PERF_EVENTS
+    for (int fd : fds) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+void HardwareCounters::stop(ProfileData& into) {
+#ifdef ENMOD_PERF_EVENTS
+    if (fds[HW_CYCLES] < 0) return;
+    ioctl(fds[HW_CYCLES], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    // Group read: the number of events, then one value per event in the order they joined
+    std::uint64_t buffer[1 + NUM_HARDWARE_COUNTERS] = {};
+    if (read(fds[HW_CYCLES], buffer, sizeof(buffer)) <= 0) return;
+    int slot = 0;
+    for (int i = 0; i < NUM_HARDWARE_COUNTERS && slot < static_cast<int>(buffer[0]); ++i) {
+        if (fds[i] >= 0) into.hardware[i] = buffer[1 + slot++];
+    }
+    into.has_hardware = true;
+#else
+    (void)into;
+#endif
+}
@@ -1,43 +1,125 @@
 #include "enmod/QLearningSolver.h"
 #include <random>
-#include <chrono>
 #include <algorithm>
 #include <vector>
 
 QLearningSolver::QLearningSolver(const Grid& grid_ref, const std::string& name) : RLSolver(grid_ref, name) {}
 
 void QLearningSolver::run() {
-    train(5000);
+    TrainingOptions options;
+    options.max_episodes = 5000;
+    runTraining(options);
     generatePolicyFromValueTable();
 }
 
 Direction QLearningSolver::chooseAction(const Position& state) {
-    static std::mt19937 rng(static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count()));
-    std::uniform_real_distribution<> dist(0.0, 1.0);
-    if (dist(rng) < epsilon) {
-        return static_cast<Direction>(rng() % 4);
+    if (rng.uniform() < epsilon) {
+        return static_cast<Direction>(rng.nextInt(NUM_ACTIONS));
     } else {
-        if (value_table.find(state) == value_table.end()) return static_cast<Direction>(rng() % 4);
-        const auto& values = value_table.at(state);
-        return static_cast<Direction>(std::distance(values.begin(), std::max_element(values.begin(), values.end())));
+        int cell = value_table.cellIndex(state);
+        if (!value_table.isVisited(cell)) return static_cast<Direction>(rng.nextInt(NUM_ACTIONS));
+        return static_cast<Direction>(value_table.bestAction(cell));
     }
 }
 
-void QLearningSolver::update(const Position& s, Direction a, double r, const Position& s_next, Direction /*a_next*/) {
-    if (value_table.find(s) == value_table.end()) value_table[s] = {0.0, 0.0, 0.0, 0.0};
-    if (value_table.find(s_next) == value_table.end()) value_table[s_next] = {0.0, 0.0, 0.0, 0.0};
-    
-    double old_value = value_table[s][static_cast<int>(a)];
-    double next_max = *std::max_element(value_table[s_next].begin(), value_table[s_next].end());
-    
-    double new_value = (1 - alpha) * old_value + alpha * (r + gamma * next_max);
-    value_table[s][static_cast<int>(a)] = new_value;
+void QLearningSolver::update(const Position& s, Direction a, double r, const Position& s_next, Direction a_next) {
+    Transition transition{value_table.cellIndex(s), static_cast<int>(a), r, value_table.cellIndex(s_next)};
+    if (lambda > 0) {
+        traceBackup(transition, static_cast<int>(a_next));
+    } else {
+        backup(transition.cell, transition.action, transition.reward, transition.next_cell);
+    }
+    if (replay_enabled) replayAndPlan(transition);
+}
+
+double QLearningSolver::backup(int cell, int action, double reward, int next_cell) {
+    value_table.markVisited(cell);
+    value_table.markVisited(next_cell);
+
+    QValue& q = value_table.at(cell, action);
+    double td_error = reward + gamma * value_table.maxValue(next_cell) - q;
+    q = static_cast<QValue>(q + alpha * td_error);
+    return td_error;
+}
+
+void QLearningSolver::traceBackup(const Transition& transition, int next_action) {
+    value_table.markVisited(transition.cell);
+    value_table.markVisited(transition.next_cell);
+
+    // Watkins Q(lambda): traces only carry credit back while the agent keeps acting greedily
+    double next_max = value_table.maxValue(transition.next_cell);
+    bool greedy_next = value_table.at(transition.next_cell, next_action) == next_max;
+    double td_error = transition.reward + gamma * next_max - value_table.at(transition.cell, transition.action);
+
+    traces.visit(transition.cell, transition.action);
+    applyTraces(td_error);
+    if (greedy_next) {
+        traces.decay(gamma * lambda);
+    } else {
+        traces.clear();
+    }
+}
+
+void QLearningSolver::enableReplay(const ReplayOptions& options) {
+    replay_enabled = true;
+    replay_options = options;
+    replay_buffer = PrioritizedReplayBuffer(options.capacity, options.priority_exponent);
+    model.reset(value_table.numCells());
+}
+
+void QLearningSolver::replayAndPlan(const Transition& transition) {
+    replay_buffer.add(transition);
+    model.record(transition);
+
+    // Replay stored transitions, most surprising first
+    for (int i = 0; i < replay_options.replay_updates && !replay_buffer.empty(); ++i) {
+        int slot = replay_buffer.sample(rng);
+        const Transition& stored = replay_buffer.get(slot);
+        replay_buffer.updatePriority(slot, backup(stored.cell, stored.action, stored.reward, stored.next_cell));
+    }
+    // Dyna-Q: simulated steps from the learned model
+    for (int i = 0; i < replay_options.planning_steps && !model.empty(); ++i) {
+        Transition simulated = model.sample(rng);
+        backup(simulated.cell, simulated.action, simulated.reward, simulated.next_cell);
+    }
+}
+
+void QLearningSolver::chooseActionBatch(int lanes, const int* cells, int* actions) {
+    for (int i = 0; i < lanes; ++i) {
+        int cell = cells[i];
+        if (rng.uniform() < epsilon || !value_table.isVisited(cell)) {
+            actions[i] = rng.nextInt(NUM_ACTIONS);
+        } else {
+            actions[i] = value_table.bestAction(cell);
+        }
+    }
+}
+
+void QLearningSolver::updateBatch(int lanes, const int* cells, const int* actions, const double* rewards,
+                                  const int* next_cells, const int* /*next_actions*/) {
+    if (replay_enabled) {
+        for (int i = 0; i < lanes; ++i) {
+            backup(cells[i], actions[i], rewards[i], next_cells[i]);
+            replayAndPlan({cells[i], actions[i], rewards[i], next_cells[i]});
+        }
+        return;
+    }
+    for (int i = 0; i < lanes; ++i) {
+        value_table.markVisited(cells[i]);
+        value_table.markVisited(next_cells[i]);
+        QValue& q = value_table.at(cells[i], actions[i]);
+        q = static_cast<QValue>((1 - alpha) * q + alpha * (rewards[i] + gamma * value_table.maxValue(next_cells[i])));
+    }
 }
 
 void QLearningSolver::train(int episodes) {
     RLSolver::train(episodes);
 }
 
+std::unique_ptr<RLSolver> QLearningSolver::clone() const {
+    return std::make_unique<QLearningSolver>(*this);
+}
+
 Cost QLearningSolver::getEvacuationCost() const {
     Position current = grid.getStartPosition();
     Cost total_cost = {0, 0, 0};
@@ -56,6 +138,14 @@ Cost QLearningSolver::getEvacuationCost() const {
 
 void QLearningSolver::generateReport(std::ofstream& report_file) const {
     report_file << "<h2>Final Learned Policy (Q-Learning)</h2>\n";
-    report_file << "<p>This policy was learned over 5000 episodes.</p>\n";
+    writeTrainingSummary(report_file);
+    writeReplaySummary(report_file);
     report_file << grid.toHtmlStringWithPolicy(policy);
-}
\ No newline at end of file
+}
+
+void QLearningSolver::writeReplaySummary(std::ofstream& report_file) const {
+    if (!replay_enabled) return;
+    report_file << "<p>Experience replay: " << replay_options.replay_updates << " prioritized replays and "
+                << replay_options.planning_steps << " Dyna-Q planning updates per real step (buffer "
+                << replay_buffer.size() << "/" << replay_buffer.capacity() << " transitions).</p>\n";
+}
@@ -0,0 +1,12 @@
+#include "enmod/QTable.h"
+
+QTable::QTable(int rows, int cols, QValue initial_value) {
+    reset(rows, cols, initial_value);
+}
+
+void QTable::reset(int r, int c, QValue initial_value) {
+    rows = r;
+    cols = c;
+    data.assign(static_cast<std::size_t>(rows) * cols * NUM_ACTIONS, initial_value);
+    visited.assign(static_cast<std::size_t>(rows) * cols, 0);
+}
@@ -1,11 +1,37 @@
 #include "enmod/RLSolver.h"
+#include "enmod/BatchEnvironment.h"
 #include "enmod/Logger.h"
-#include <random>
-#include <chrono>
+#include "enmod/ParallelTrainer.h"
+#include "enmod/PolicyArtifact.h"
+#include "enmod/Profiler.h"
 #include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Window metrics from totals over `episodes` episodes.
+TrainingSummary averaged(int episodes, double total_steps, double total_return, int exits, double max_delta) {
+    TrainingSummary summary;
+    summary.episodes = episodes;
+    if (episodes <= 0) return summary;
+    summary.mean_steps = total_steps / episodes;
+    summary.mean_return = total_return / episodes;
+    summary.exit_rate = static_cast<double>(exits) / episodes;
+    summary.max_delta_q = max_delta;
+    return summary;
+}
+
+} // namespace
 
 RLSolver::RLSolver(const Grid& grid_ref, const std::string& name)
-    : Solver(grid_ref, name), policy(grid_ref.getRows(), grid_ref.getCols()) {}
+    : Solver(grid_ref, name), value_table(grid_ref.getRows(), grid_ref.getCols()), policy(grid_ref.getRows(), grid_ref.getCols()),
+      rng(deriveSeed(run_seed, name)), traces(value_table.numCells() * NUM_ACTIONS) {}
+
+Direction RLSolver::greedyAction(const Position& state) const {
+    int cell = value_table.cellIndex(state);
+    if (!value_table.isVisited(cell)) return Direction::STAY;
+    return static_cast<Direction>(value_table.bestAction(cell));
+}
 
 const Policy& RLSolver::getPolicy() {
     generatePolicyFromValueTable();
@@ -13,40 +39,358 @@ const Policy& RLSolver::getPolicy() {
 }
 
 void RLSolver::run() {
-    train(5000); // Default training for static planners
+    TrainingOptions options;
+    options.max_episodes = 5000; // Default budget for static planners
+    runTraining(options);
     generatePolicyFromValueTable();
 }
 
+TrainingSummary RLSolver::runTraining(const TrainingOptions& options) {
+    if (training_workers <= 1) return trainUntilConverged(options);
+    TrainingStats stats = ParallelTrainer(training_workers).train(*this, options);
+    training_summary = stats.last_round;
+    training_summary.episodes = stats.episodes;
+    training_summary.converged = stats.converged;
+    return training_summary;
+}
+
 void RLSolver::train(int episodes) {
-     for (int i = 0; i < episodes; ++i) {
-        Position state = grid.getStartPosition();
-        Direction action = chooseAction(state);
-
-        for (int t = 0; t < grid.getRows() * grid.getCols(); ++t) {
-            Position next_state = grid.getNextPosition(state, action);
-            
-            double reward = -1;
-            if (!grid.isWalkable(next_state.row, next_state.col)) {
-                reward = -100; next_state = state;
-            } else if (grid.isExit(next_state.row, next_state.col)) {
-                reward = 1000;
-            } else if (grid.getCellType(next_state) == CellType::SMOKE) {
-                reward = -20;
-            } else if (grid.getCellType(next_state) == CellType::FIRE) {
-                reward = -200;
+    ENMOD_PROFILE_PHASE(PHASE_TRAINING);
+    syncWithValueTable();
+    BatchEnvironment env(grid);
+    runEpisodes(env, grid.getRows() * grid.getCols(), 0, episodes, nullptr);
+}
+
+EpisodeMetrics RLSolver::runEpisode(const BatchEnvironment& env, int horizon) {
+    EpisodeMetrics metrics;
+    ENMOD_PROFILE_COUNT(COUNTER_EPISODES, 1);
+    onEpisodeStart();
+    int cell = env.startCell();
+    Direction action = chooseAction(env.cellPosition(cell));
+
+    for (int t = 0; t < horizon; ++t) {
+        int a = static_cast<int>(action);
+        int next_cell = env.nextCell(cell, a);
+        Position next_state = env.cellPosition(next_cell);
+        double reward = env.reward(cell, a);
+
+        Direction next_action = chooseAction(next_state);
+        QValue old_value = value_table.at(cell, a);
+        update(env.cellPosition(cell), action, reward, next_state, next_action);
+        metrics.max_delta_q = std::max(metrics.max_delta_q, std::abs(static_cast<double>(value_table.at(cell, a) - old_value)));
+        metrics.episode_return += reward;
+        metrics.steps = t + 1;
+
+        cell = next_cell;
+        action = next_action;
+
+        if (env.isTerminal(cell)) {
+            metrics.reached_exit = true;
+            break;
+        }
+    }
+    return metrics;
+}
+
+TrainingSummary RLSolver::trainUntilConverged(const TrainingOptions& options) {
+    ENMOD_PROFILE_PHASE(PHASE_TRAINING);
+    syncWithValueTable();
+    BatchEnvironment env(grid);
+    int horizon = grid.getRows() * grid.getCols();
+    TrainingSummary summary;
+
+    std::vector<int> previous = greedyActions();
+    int stable_checks = 0;
+
+    while (summary.episodes < options.max_episodes) {
+        int remaining = options.max_episodes - summary.episodes;
+        bool window_full = options.check_interval > 0 && options.check_interval <= remaining;
+        TrainingSummary window = runEpisodes(env, horizon, summary.episodes, window_full ? options.check_interval : remaining,
+                                             options.on_episode);
+
+        summary.episodes += window.episodes;
+        summary.mean_steps = window.mean_steps;
+        summary.mean_return = window.mean_return;
+        summary.exit_rate = window.exit_rate;
+        summary.max_delta_q = window.max_delta_q;
+        if (!window_full) break;
+
+        std::vector<int> current = greedyActions();
+        // A policy that never reaches an exit in the window has not converged, however stable it looks.
+        bool stable = current == previous && window.exit_rate > 0.0 &&
+                      (options.delta_tolerance <= 0.0 || window.max_delta_q <= options.delta_tolerance) &&
+                      (!options.require_greedy_exit || greedyReachesExit(env, horizon));
+        stable_checks = stable ? stable_checks + 1 : 0;
+        if (stable_checks >= options.patience) {
+            summary.converged = true;
+            break;
+        }
+        previous = std::move(current);
+    }
+
+    training_summary = summary;
+    return summary;
+}
+
+TrainingSummary RLSolver::runEpisodes(const BatchEnvironment& env, int horizon, int first_episode, int episodes,
+                                      const std::function<void(const EpisodeMetrics&)>& on_episode) {
+    // Traces follow a single episode, so only one-step learners run the episodes in lock-step. Each
+    // lane runs several episodes back to back, so later episodes still start from what earlier
+    // ones learned; a lane per episode would send a short budget out all at once on a cold table.
+    if (batch_lanes > 0 && lambda == 0.0 && !on_episode) {
+        return runBatch(env, horizon, episodes, std::min(batch_lanes, episodes / EPISODES_PER_LANE));
+    }
+
+    double total_steps = 0.0, total_return = 0.0, max_delta = 0.0;
+    int exits = 0;
+    for (int i = 0; i < episodes; ++i) {
+        EpisodeMetrics metrics = runEpisode(env, horizon);
+        metrics.episode = first_episode + i;
+        if (on_episode) on_episode(metrics);
+
+        total_steps += metrics.steps;
+        total_return += metrics.episode_return;
+        exits += metrics.reached_exit ? 1 : 0;
+        max_delta = std::max(max_delta, metrics.max_delta_q);
+    }
+    return averaged(episodes, total_steps, total_return, exits, max_delta);
+}
+
+void RLSolver::applyTraces(double td_error) {
+    double step = alpha * td_error;
+    for (int i = 0; i < traces.size(); ++i) {
+        int key = traces.key(i);
+        QValue& q = value_table.at(key / NUM_ACTIONS, key % NUM_ACTIONS);
+        q = static_cast<QValue>(q + step * traces.value(i));
+    }
+}
+
+void RLSolver::trainBatch(int episodes, int lanes) {
+    if (episodes <= 0) return;
+    ENMOD_PROFILE_PHASE(PHASE_TRAINING);
+    syncWithValueTable();
+    BatchEnvironment env(grid);
+    runBatch(env, grid.getRows() * grid.getCols(), episodes, lanes);
+}
+
+TrainingSummary RLSolver::runBatch(const BatchEnvironment& env, int horizon, int episodes, int lanes) {
+    if (episodes <= 0) return {};
+    ENMOD_PROFILE_COUNT(COUNTER_EPISODES, episodes);
+    lanes = std::max(1, std::min(lanes, episodes));
+
+    // Per-lane episode state, kept compact: lanes [0, active) are running.
+    std::vector<int> cells(lanes, env.startCell()), actions(lanes), next_cells(lanes), next_actions(lanes), steps(lanes, 0);
+    std::vector<double> rewards(lanes), returns(lanes, 0.0);
+    std::vector<QValue> old_values(lanes);
+    std::vector<unsigned char> done(lanes);
+    chooseActionBatch(lanes, cells.data(), actions.data());
+
+    double total_steps = 0.0, total_return = 0.0, max_delta = 0.0;
+    int exits = 0;
+    int active = lanes;
+    int started = lanes;
+    while (active > 0) {
+        env.step(active, cells.data(), actions.data(), next_cells.data(), rewards.data(), done.data());
+        chooseActionBatch(active, next_cells.data(), next_actions.data());
+        for (int i = 0; i < active; ++i) old_values[i] = value_table.at(cells[i], actions[i]);
+        updateBatch(active, cells.data(), actions.data(), rewards.data(), next_cells.data(), next_actions.data());
+
+        for (int i = 0; i < active; ++i) {
+            max_delta = std::max(max_delta, std::abs(static_cast<double>(value_table.at(cells[i], actions[i]) - old_values[i])));
+            returns[i] += rewards[i];
+            cells[i] = next_cells[i];
+            actions[i] = next_actions[i];
+            if (!done[i] && ++steps[i] < horizon) continue;
+
+            total_steps += done[i] ? steps[i] + 1 : steps[i];
+            total_return += returns[i];
+            exits += done[i] ? 1 : 0;
+            if (started < episodes) {
+                ++started;
+                cells[i] = env.startCell();
+                actions[i] = static_cast<int>(chooseAction(env.cellPosition(cells[i])));
+                steps[i] = 0;
+                returns[i] = 0.0;
+            } else {
+                // Retire the lane by moving the last running lane into its slot.
+                --active;
+                cells[i] = cells[active];
+                actions[i] = actions[active];
+                steps[i] = steps[active];
+                returns[i] = returns[active];
+                rewards[i] = rewards[active];
+                old_values[i] = old_values[active];
+                done[i] = done[active];
+                next_cells[i] = next_cells[active];
+                next_actions[i] = next_actions[active];
+                --i;
             }
-            
-            Direction next_action = chooseAction(next_state);
-            update(state, action, reward, next_state, next_action);
+        }
+    }
+    return averaged(episodes, total_steps, total_return, exits, max_delta);
+}
+
+void RLSolver::chooseActionBatch(int lanes, const int* cells, int* actions) {
+    for (int i = 0; i < lanes; ++i) {
+        actions[i] = static_cast<int>(chooseAction(value_table.cellPosition(cells[i])));
+    }
+}
 
-            state = next_state;
-            action = next_action;
+void RLSolver::updateBatch(int lanes, const int* cells, const int* actions, const double* rewards,
+                           const int* next_cells, const int* next_actions) {
+    for (int i = 0; i < lanes; ++i) {
+        update(value_table.cellPosition(cells[i]), static_cast<Direction>(actions[i]), rewards[i],
+               value_table.cellPosition(next_cells[i]), static_cast<Direction>(next_actions[i]));
+    }
+}
+
+std::vector<double> RLSolver::stateValuesFromCostMap(const std::vector<std::vector<Cost>>& cost_map) const {
+    BatchEnvironment env(grid);
+    // Value of a cell that cannot reach an exit: a -1 step reward forever.
+    const double unreachable_value = -1.0 / (1.0 - gamma);
+    std::vector<double> values(env.numCells(), unreachable_value);
+
+    std::vector<int> order;
+    for (int cell = 0; cell < env.numCells(); ++cell) {
+        Position pos = env.cellPosition(cell);
+        if (grid.isWalkable(pos.row, pos.col) && cost_map[pos.row][pos.col].distance != MAX_COST) {
+            order.push_back(cell);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        Position pa = env.cellPosition(a), pb = env.cellPosition(b);
+        return cost_map[pa.row][pa.col] < cost_map[pb.row][pb.col];
+    });
 
-            if (grid.isExit(state.row, state.col)) {
-                break;
+    // Cells are visited in increasing cost, so the greedy successor is always resolved first.
+    for (int cell : order) {
+        if (env.isTerminal(cell)) {
+            values[cell] = 0.0;
+            continue;
+        }
+        Position pos = env.cellPosition(cell);
+        int best_action = -1;
+        Cost best_cost = cost_map[pos.row][pos.col];
+        for (int a = 0; a < NUM_ACTIONS; ++a) {
+            int next_cell = env.nextCell(cell, a);
+            if (next_cell == cell) continue;
+            Position next = env.cellPosition(next_cell);
+            if (cost_map[next.row][next.col] < best_cost) {
+                best_cost = cost_map[next.row][next.col];
+                best_action = a;
             }
         }
+        if (best_action >= 0) {
+            int next_cell = env.nextCell(cell, best_action);
+            double next_value = env.isTerminal(next_cell) ? 0.0 : values[next_cell];
+            values[cell] = env.reward(cell, best_action) + gamma * next_value;
+        }
     }
+    return values;
+}
+
+void RLSolver::initializeFromCostMap(const std::vector<std::vector<Cost>>& cost_map) {
+    BatchEnvironment env(grid);
+    std::vector<double> values = stateValuesFromCostMap(cost_map);
+
+    for (int cell = 0; cell < env.numCells(); ++cell) {
+        Position pos = env.cellPosition(cell);
+        if (!grid.isWalkable(pos.row, pos.col) || cost_map[pos.row][pos.col].distance == MAX_COST) continue;
+        for (int a = 0; a < NUM_ACTIONS; ++a) {
+            int next_cell = env.nextCell(cell, a);
+            double next_value = env.isTerminal(next_cell) ? 0.0 : values[next_cell];
+            value_table.at(cell, a) = static_cast<QValue>(env.reward(cell, a) + gamma * next_value);
+        }
+        value_table.markVisited(cell);
+    }
+}
+
+std::vector<int> RLSolver::greedyActions() const {
+    std::vector<int> actions(value_table.numCells(), -1);
+    for (int cell = 0; cell < value_table.numCells(); ++cell) {
+        if (value_table.isVisited(cell)) actions[cell] = value_table.bestAction(cell);
+    }
+    return actions;
+}
+
+bool RLSolver::greedyReachesExit() const {
+    return greedyReachesExit(BatchEnvironment(grid), grid.getRows() * grid.getCols());
+}
+
+double RLSolver::mergeWorkers(const std::vector<const RLSolver*>& workers) {
+    double max_delta = 0.0;
+    for (int cell = 0; cell < value_table.numCells(); ++cell) {
+        QValue sum[NUM_ACTIONS] = {};
+        int contributors = 0;
+        for (const RLSolver* worker : workers) {
+            if (!worker->value_table.isVisited(cell)) continue;
+            const QValue* q = worker->value_table.values(cell);
+            for (int a = 0; a < NUM_ACTIONS; ++a) sum[a] += q[a];
+            ++contributors;
+        }
+        if (contributors == 0) continue;
+
+        QValue* q = value_table.values(cell);
+        for (int a = 0; a < NUM_ACTIONS; ++a) {
+            QValue merged = sum[a] / contributors;
+            max_delta = std::max(max_delta, static_cast<double>(std::abs(merged - q[a])));
+            q[a] = merged;
+        }
+        value_table.markVisited(cell);
+    }
+    syncWithValueTable();
+    return max_delta;
+}
+
+bool RLSolver::greedyReachesExit(const BatchEnvironment& env, int horizon) const {
+    std::vector<unsigned char> seen(env.numCells(), 0);
+    int cell = env.startCell();
+    for (int t = 0; t <= horizon; ++t) {
+        if (env.isTerminal(cell)) return true;
+        if (seen[cell] || !value_table.isVisited(cell)) return false;
+        seen[cell] = 1;
+        cell = env.nextCell(cell, value_table.bestAction(cell));
+    }
+    return false;
+}
+
+int RLSolver::fineTune(int max_episodes, int check_interval, int patience) {
+    TrainingOptions options;
+    options.max_episodes = max_episodes;
+    options.check_interval = check_interval;
+    options.patience = patience;
+    return trainUntilConverged(options).episodes;
+}
+
+std::uint64_t RLSolver::trainingHash(int max_episodes, int check_interval, int patience) const {
+    std::uint64_t seed = deriveSeed(run_seed, solver_name);
+    double parameters[] = {alpha, gamma, epsilon, lambda};
+    std::int32_t budget[] = {max_episodes, check_interval, patience};
+    std::uint64_t hash = PolicyArtifact::hashBytes(&seed, sizeof(seed));
+    hash = PolicyArtifact::hashBytes(parameters, sizeof(parameters), hash);
+    return PolicyArtifact::hashBytes(budget, sizeof(budget), hash);
+}
+
+bool RLSolver::saveValueTable(const std::string& path, std::uint64_t training_hash) const {
+    return PolicyArtifact::save(path, value_table, PolicyArtifact::gridHash(grid), training_hash);
+}
+
+bool RLSolver::loadValueTable(const std::string& path, std::uint64_t training_hash) {
+    ValueTable loaded;
+    if (!PolicyArtifact::load(path, PolicyArtifact::gridHash(grid), training_hash, loaded)) return false;
+    if (loaded.getRows() != grid.getRows() || loaded.getCols() != grid.getCols()) return false;
+    value_table = std::move(loaded);
+    syncWithValueTable();
+    generatePolicyFromValueTable();
+    return true;
+}
+
+void RLSolver::writeTrainingSummary(std::ofstream& report_file) const {
+    report_file << "<p>This policy was learned over " << training_summary.episodes << " episodes"
+                << (training_summary.converged ? " (stopped early: greedy policy converged)" : "") << ".</p>\n";
+    report_file << "<p>Last window: " << training_summary.mean_steps << " steps/episode, return "
+                << training_summary.mean_return << ", exit rate " << training_summary.exit_rate
+                << ", max |dQ| " << training_summary.max_delta_q << ".</p>\n";
 }
 
 void RLSolver::generatePolicyFromValueTable() {
@@ -54,11 +398,9 @@ void RLSolver::generatePolicyFromValueTable() {
         for (int c = 0; c < grid.getCols(); ++c) {
             Position pos = {r, c};
             if (grid.isWalkable(r, c)) {
-                auto it = value_table.find(pos);
-                if (it != value_table.end()) {
-                    const auto& values = it->second;
-                    int best_action_idx = static_cast<int>(std::distance(values.begin(), std::max_element(values.begin(), values.end())));
-                    policy.setDirection(pos, static_cast<Direction>(best_action_idx));
+                int cell = value_table.cellIndex(pos);
+                if (value_table.isVisited(cell)) {
+                    policy.setDirection(pos, static_cast<Direction>(value_table.bestAction(cell)));
                 } else {
                     policy.setDirection(pos, Direction::NONE);
                 }
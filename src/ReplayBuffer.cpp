@@ -0,0 +1,75 @@
+#include "enmod/ReplayBuffer.h"
+#include "enmod/QTable.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const double MIN_PRIORITY = 1e-3; // Keeps zero-error transitions sampleable
+}
+
+PrioritizedReplayBuffer::PrioritizedReplayBuffer(int capacity, double priority_exponent)
+    : transitions(std::max(1, capacity)), tree(2 * static_cast<size_t>(std::max(1, capacity)), 0.0),
+      exponent(priority_exponent) {}
+
+void PrioritizedReplayBuffer::clear() {
+    std::fill(tree.begin(), tree.end(), 0.0);
+    max_priority = 1.0;
+    next_slot = 0;
+    count = 0;
+}
+
+void PrioritizedReplayBuffer::add(const Transition& transition) {
+    transitions[next_slot] = transition;
+    setPriority(next_slot, max_priority);
+    next_slot = (next_slot + 1) % capacity();
+    count = std::min(count + 1, capacity());
+}
+
+int PrioritizedReplayBuffer::sample(Xoshiro256& rng) const {
+    int cap = capacity();
+    double target = rng.uniform() * tree[1];
+    int node = 1;
+    while (node < cap) {
+        int left = 2 * node;
+        if (target < tree[left]) {
+            node = left;
+        } else {
+            target -= tree[left];
+            node = left + 1;
+        }
+    }
+    // Rounding can walk past the last filled leaf; clamp back into the stored range.
+    return std::min(node - cap, count - 1);
+}
+
+void PrioritizedReplayBuffer::updatePriority(int slot, double td_error) {
+    double priority = std::pow(std::abs(td_error) + MIN_PRIORITY, exponent);
+    max_priority = std::max(max_priority, priority);
+    setPriority(slot, priority);
+}
+
+void PrioritizedReplayBuffer::setPriority(int slot, double priority) {
+    int node = slot + capacity();
+    double change = priority - tree[node];
+    for (; node >= 1; node /= 2) tree[node] += change;
+}
+
+void DynaModel::reset(int num_cells) {
+    size_t pairs = static_cast<size_t>(num_cells) * NUM_ACTIONS;
+    next_cells.assign(pairs, -1);
+    rewards.assign(pairs, 0.0);
+    observed.clear();
+    observed.reserve(pairs);
+}
+
+void DynaModel::record(const Transition& transition) {
+    int key = transition.cell * NUM_ACTIONS + transition.action;
+    if (next_cells[key] < 0) observed.push_back(key);
+    next_cells[key] = transition.next_cell;
+    rewards[key] = transition.reward;
+}
+
+Transition DynaModel::sample(Xoshiro256& rng) const {
+    int key = observed[rng.nextInt(static_cast<int>(observed.size()))];
+    return {key / NUM_ACTIONS, key % NUM_ACTIONS, rewards[key], next_cells[key]};
+}
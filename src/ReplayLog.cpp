@@ -0,0 +1,183 @@
+#include "enmod/ReplayLog.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+
+enum RecordType : std::uint8_t { RECORD_HAZARD = 1, RECORD_KEYFRAME = 2, RECORD_STEP = 3 };
+
+constexpr std::size_t HEADER_BYTES = 32; // Up to the config
+constexpr std::size_t FLUSH_BYTES = 1 << 16;
+
+void appendU32(std::vector<std::uint8_t>& out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+}
+
+void appendU64(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+}
+
+void appendI32(std::vector<std::uint8_t>& out, int value) { appendU32(out, static_cast<std::uint32_t>(value)); }
+
+void appendPositions(std::vector<std::uint8_t>& out, const std::vector<Position>& positions) {
+    for (const auto& pos : positions) {
+        appendI32(out, pos.row);
+        appendI32(out, pos.col);
+    }
+}
+
+std::uint32_t getU32(const std::uint8_t* in) {
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) value |= static_cast<std::uint32_t>(in[i]) << (8 * i);
+    return value;
+}
+
+std::uint64_t getU64(const std::uint8_t* in) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+    return value;
+}
+
+int getI32(const std::uint8_t* in) { return static_cast<int>(getU32(in)); }
+
+// Grid::getNextPosition without the grid: moves are recorded as carried out, walls included.
+Position stepFrom(const Position& pos, Direction move) {
+    switch (move) {
+        case Direction::UP: return {pos.row - 1, pos.col};
+        case Direction::DOWN: return {pos.row + 1, pos.col};
+        case Direction::LEFT: return {pos.row, pos.col - 1};
+        case Direction::RIGHT: return {pos.row, pos.col + 1};
+        default: return pos;
+    }
+}
+
+} // namespace
+
+ReplayRecorder::ReplayRecorder(const std::string& path, const json& config, std::uint64_t seed, const std::vector<Position>& starts)
+    : out(path, std::ios::binary | std::ios::trunc), expected(starts) {
+    if (!out) throw std::runtime_error("Could not create replay log " + path);
+    std::vector<std::uint8_t> cbor = json::to_cbor(config);
+    buffer.insert(buffer.end(), {'E', 'R', 'P', 'L', VERSION, 0, 0, 0});
+    appendU64(buffer, seed);
+    appendU64(buffer, hashConfig(config));
+    appendU32(buffer, static_cast<std::uint32_t>(starts.size()));
+    appendU32(buffer, static_cast<std::uint32_t>(cbor.size()));
+    buffer.insert(buffer.end(), cbor.begin(), cbor.end());
+    appendPositions(buffer, starts);
+}
+
+ReplayRecorder::~ReplayRecorder() { flush(); }
+
+std::uint64_t ReplayRecorder::hashConfig(const json& config) {
+    std::uint64_t hash = 0xCBF29CE484222325ULL; // FNV-1a
+    for (unsigned char ch : config.dump()) {
+        hash ^= ch;
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+void ReplayRecorder::recordHazard(int timestep, std::size_t event_index) {
+    buffer.push_back(RECORD_HAZARD);
+    appendI32(buffer, timestep);
+    appendU32(buffer, static_cast<std::uint32_t>(event_index));
+}
+
+void ReplayRecorder::recordStep(int timestep, const std::vector<Position>& positions, const std::vector<Direction>& moves,
+                                const std::vector<EvacuationMode>& modes) {
+    if (steps_since_keyframe == KEYFRAME_INTERVAL || positions != expected) {
+        buffer.push_back(RECORD_KEYFRAME);
+        appendI32(buffer, timestep);
+        appendPositions(buffer, positions);
+        steps_since_keyframe = 0;
+    }
+    buffer.push_back(RECORD_STEP);
+    appendI32(buffer, timestep);
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        buffer.push_back(static_cast<std::uint8_t>(static_cast<int>(moves[i]) | (static_cast<int>(modes[i]) << 4)));
+        expected[i] = stepFrom(positions[i], moves[i]);
+    }
+    ++steps_since_keyframe;
+    if (buffer.size() >= FLUSH_BYTES) flush();
+}
+
+void ReplayRecorder::flush() {
+    if (buffer.empty()) return;
+    out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    out.flush();
+    buffer.clear();
+}
+
+ReplayReader::ReplayReader(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("Could not open replay log " + path);
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (data.size() < HEADER_BYTES || std::memcmp(data.data(), "ERPL", 4) != 0 || data[4] != ReplayRecorder::VERSION) {
+        throw std::runtime_error(path + " is not a replay log of this version");
+    }
+    seed = getU64(&data[8]);
+    grid_hash = getU64(&data[16]);
+    std::size_t agents = getU32(&data[24]);
+    std::size_t config_bytes = getU32(&data[28]);
+    std::size_t offset = HEADER_BYTES + config_bytes;
+    if (offset + agents * 8 > data.size()) throw std::runtime_error(path + " is truncated");
+    try {
+        config = json::from_cbor(data.begin() + HEADER_BYTES, data.begin() + offset);
+    } catch (const json::exception& e) {
+        throw std::runtime_error(path + " holds an unreadable scenario: " + e.what());
+    }
+    if (ReplayRecorder::hashConfig(config) != grid_hash) throw std::runtime_error(path + " does not match its grid hash");
+    keyframes.push_back({0, offset});
+    starts.resize(agents);
+    readPositions(offset, starts);
+    offset += agents * 8;
+
+    // A run that stopped mid-write leaves a partial last record, which is ignored
+    while (offset + 5 <= data.size()) {
+        std::uint8_t type = data[offset];
+        int timestep = getI32(&data[offset + 1]);
+        std::size_t body = offset + 5;
+        if (type != RECORD_HAZARD && type != RECORD_KEYFRAME && type != RECORD_STEP) throw std::runtime_error(path + " holds an unknown record type");
+        std::size_t length = type == RECORD_HAZARD ? 4 : type == RECORD_KEYFRAME ? agents * 8 : agents;
+        if (body + length > data.size()) break;
+        if (type == RECORD_HAZARD) {
+            hazards.push_back({timestep, getU32(&data[body])});
+        } else if (type == RECORD_KEYFRAME) {
+            keyframes.push_back({timestep, body});
+        } else {
+            if (timestep != static_cast<int>(steps.size())) throw std::runtime_error(path + " skips from timestep " + std::to_string(steps.size()));
+            steps.push_back(body);
+        }
+        offset = body + length;
+    }
+}
+
+void ReplayReader::readPositions(std::size_t offset, std::vector<Position>& positions) const {
+    for (std::size_t i = 0; i < positions.size(); ++i) positions[i] = {getI32(&data[offset + 8 * i]), getI32(&data[offset + 8 * i + 4])};
+}
+
+ReplayState ReplayReader::stateAt(int timestep) const {
+    if (timestep < 0 || timestep >= getNumSteps()) throw std::out_of_range("Timestep " + std::to_string(timestep) + " is not in the replay");
+    ReplayState state{timestep, Grid(config), std::vector<Position>(starts.size()), {}, {}};
+    for (const auto& hazard : hazards) {
+        if (hazard.timestep <= timestep) state.grid.addHazard(config.at("dynamic_events").at(hazard.event_index));
+    }
+
+    // The last keyframe at or before timestep; of two for one timestep, the later one
+    auto keyframe = std::upper_bound(keyframes.begin(), keyframes.end(), timestep,
+                                     [](int t, const Keyframe& k) { return t < k.timestep; }) - 1;
+    readPositions(keyframe->offset, state.positions);
+    for (int t = keyframe->timestep; t < timestep; ++t) {
+        const std::uint8_t* moves = &data[steps[t]];
+        for (std::size_t i = 0; i < state.positions.size(); ++i) state.positions[i] = stepFrom(state.positions[i], static_cast<Direction>(moves[i] & 0x0F));
+    }
+
+    const std::uint8_t* current = &data[steps[timestep]];
+    for (std::size_t i = 0; i < starts.size(); ++i) {
+        state.moves.push_back(static_cast<Direction>(current[i] & 0x0F));
+        state.modes.push_back(static_cast<EvacuationMode>(current[i] >> 4));
+    }
+    return state;
+}
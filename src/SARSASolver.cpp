@@ -1,13 +1,14 @@
 #include "enmod/SARSASolver.h"
 #include <random>
-#include <chrono>
 #include <algorithm>
 #include <vector>
 
-SARSASolver::SARSASolver(const Grid& grid_ref) : RLSolver(grid_ref, "SARSA") {}
+SARSASolver::SARSASolver(const Grid& grid_ref, const std::string& name) : RLSolver(grid_ref, name) {}
 
 void SARSASolver::run() {
-    train(5000); // Static training run
+    TrainingOptions options;
+    options.max_episodes = 5000; // Static training run
+    runTraining(options);
     generatePolicyFromValueTable();
 }
 
@@ -16,30 +17,62 @@ void SARSASolver::train(int episodes) {
 }
 
 Direction SARSASolver::chooseAction(const Position& state) {
-    static std::mt19937 rng(static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count()));
-    std::uniform_real_distribution<> dist(0.0, 1.0);
-
-    if (dist(rng) < epsilon) {
-        return static_cast<Direction>(rng() % 4);
+    if (rng.uniform() < epsilon) {
+        return static_cast<Direction>(rng.nextInt(NUM_ACTIONS));
     } else {
-        if (value_table.find(state) == value_table.end()) {
-             return static_cast<Direction>(rng() % 4);
+        int cell = value_table.cellIndex(state);
+        if (!value_table.isVisited(cell)) {
+             return static_cast<Direction>(rng.nextInt(NUM_ACTIONS));
         }
-        const auto& values = value_table.at(state);
-        return static_cast<Direction>(std::distance(values.begin(), std::max_element(values.begin(), values.end())));
+        return static_cast<Direction>(value_table.bestAction(cell));
     }
 }
 
 void SARSASolver::update(const Position& s, Direction a, double r, const Position& s_next, Direction a_next) {
-    if (value_table.find(s) == value_table.end()) value_table[s] = {0.0, 0.0, 0.0, 0.0};
-    if (value_table.find(s_next) == value_table.end()) value_table[s_next] = {0.0, 0.0, 0.0, 0.0};
-    
-    double old_value = value_table[s][static_cast<int>(a)];
-    double next_value = value_table[s_next][static_cast<int>(a_next)];
-    
+    int cell = value_table.cellIndex(s);
+    int next_cell = value_table.cellIndex(s_next);
+    value_table.markVisited(cell);
+    value_table.markVisited(next_cell);
+
+    QValue& q = value_table.at(cell, static_cast<int>(a));
+    double next_value = value_table.at(next_cell, static_cast<int>(a_next));
+
+    if (lambda > 0) {
+        // SARSA(lambda): credit flows back along every recently visited pair
+        double td_error = r + gamma * next_value - q;
+        traces.visit(cell, static_cast<int>(a));
+        applyTraces(td_error);
+        traces.decay(gamma * lambda);
+        return;
+    }
+
     // The SARSA update rule
-    double new_value = old_value + alpha * (r + gamma * next_value - old_value);
-    value_table[s][static_cast<int>(a)] = new_value;
+    q = static_cast<QValue>(q + alpha * (r + gamma * next_value - q));
+}
+
+void SARSASolver::chooseActionBatch(int lanes, const int* cells, int* actions) {
+    for (int i = 0; i < lanes; ++i) {
+        int cell = cells[i];
+        if (rng.uniform() < epsilon || !value_table.isVisited(cell)) {
+            actions[i] = rng.nextInt(NUM_ACTIONS);
+        } else {
+            actions[i] = value_table.bestAction(cell);
+        }
+    }
+}
+
+void SARSASolver::updateBatch(int lanes, const int* cells, const int* actions, const double* rewards,
+                              const int* next_cells, const int* next_actions) {
+    for (int i = 0; i < lanes; ++i) {
+        value_table.markVisited(cells[i]);
+        value_table.markVisited(next_cells[i]);
+        QValue& q = value_table.at(cells[i], actions[i]);
+        q = static_cast<QValue>(q + alpha * (rewards[i] + gamma * value_table.at(next_cells[i], next_actions[i]) - q));
+    }
+}
+
+std::unique_ptr<RLSolver> SARSASolver::clone() const {
+    return std::make_unique<SARSASolver>(*this);
 }
 
 Cost SARSASolver::getEvacuationCost() const {
@@ -60,6 +93,6 @@ Cost SARSASolver::getEvacuationCost() const {
 
 void SARSASolver::generateReport(std::ofstream& report_file) const {
     report_file << "<h2>Final Learned Policy (SARSA)</h2>\n";
-    report_file << "<p>This policy was learned over 5000 episodes.</p>\n";
+    writeTrainingSummary(report_file);
     report_file << grid.toHtmlStringWithPolicy(policy);
 }
\ No newline at end of file
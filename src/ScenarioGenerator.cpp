@@ -9,12 +9,16 @@
 using json = nlohmann::json;
 
 json ScenarioGenerator::generate(int size, const std::string& name) {
+    return generate(size, name, static_cast<std::uint32_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+}
+
+json ScenarioGenerator::generate(int size, const std::string& name, std::uint32_t seed) {
     json config;
     config["name"] = name;
     config["rows"] = size;
     config["cols"] = size;
 
-    std::mt19937 rng(static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count()));
+    std::mt19937 rng(seed);
     std::uniform_int_distribution<int> dist(0, size - 1);
     
     Position start_pos = {1, 1};
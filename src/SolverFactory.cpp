@@ -0,0 +1,80 @@
+#include "enmod/SolverFactory.h"
+// Static DP Solvers
+#include "enmod/BIDP.h"
+#include "enmod/FIDP.h"
+#include "enmod/API.h"
+// Dynamic DP Solvers
+#include "enmod/DynamicBIDPSolver.h"
+#include "enmod/DynamicAPISolver.h"
+#include "enmod/DynamicFIDPSolver.h"
+#include "enmod/DynamicAVISolver.h"
+// RL Solvers (Static and Dynamic headers)
+#include "enmod/QLearningSolver.h"
+#include "enmod/SARSASolver.h"
+#include "enmod/ActorCriticSolver.h"
+#include "enmod/FeatureQLearningSolver.h"
+#include "enmod/DynamicQLearningSolver.h"
+#include "enmod/DynamicSARSASolver.h"
+#include "enmod/DynamicActorCriticSolver.h"
+#include "enmod/DynamicFeatureQLearningSolver.h"
+// EnMod-DP Solvers
+#include "enmod/HybridDPRLSolver.h"
+#include "enmod/AdaptiveCostSolver.h"
+#include "enmod/InterlacedSolver.h"
+#include "enmod/HierarchicalSolver.h"
+#include "enmod/PolicyBlendingSolver.h"
+#include <utility>
+
+namespace {
+
+template <typename T>
+std::unique_ptr<Solver> make(const Grid& grid) { return std::make_unique<T>(grid); }
+
+using Creator = std::unique_ptr<Solver> (*)(const Grid&);
+
+const std::vector<std::pair<std::string, Creator>>& registry() {
+    static const std::vector<std::pair<std::string, Creator>> solvers = {
+        // --- Static Planners ---
+        {"BIDP", make<BIDP>},
+        {"FIDP", make<FIDP>},
+        {"API", make<API>},
+        {"QLearning", make<QLearningSolver>},
+        {"SARSA", make<SARSASolver>},
+        {"ActorCritic", make<ActorCriticSolver>},
+        {"FeatureQLearning", make<FeatureQLearningSolver>},
+        // --- Dynamic Simulators ---
+        {"DynamicBIDPSim", make<DynamicBIDPSolver>},
+        {"DynamicFIDPSim", make<DynamicFIDPSolver>},
+        {"DynamicAVISim", make<DynamicAVISolver>},
+        {"DynamicAPISim", make<DynamicAPISolver>},
+        {"DynamicQLearningSim", make<DynamicQLearningSolver>},
+        {"DynamicSARSASim", make<DynamicSARSASolver>},
+        {"DynamicActorCriticSim", make<DynamicActorCriticSolver>},
+        {"DynamicFeatureQSim", make<DynamicFeatureQLearningSolver>},
+        // --- EnMod-DP Hybrid Approaches ---
+        {"HybridDPRLSim", make<HybridDPRLSolver>},
+        {"AdaptiveCostSim", make<AdaptiveCostSolver>},
+        {"InterlacedSim", make<InterlacedSolver>},
+        {"HierarchicalSim", make<HierarchicalSolver>},
+        {"PolicyBlendingSim", make<PolicyBlendingSolver>},
+    };
+    return solvers;
+}
+
+} // namespace
+
+const std::vector<std::string>& SolverFactory::solverNames() {
+    static const std::vector<std::string> names = [] {
+        std::vector<std::string> result;
+        for (const auto& entry : registry()) result.push_back(entry.first);
+        return result;
+    }();
+    return names;
+}
+
+std::unique_ptr<Solver> SolverFactory::create(const std::string& name, const Grid& grid) {
+    for (const auto& entry : registry()) {
+        if (entry.first == name) return entry.second(grid);
+    }
+    return nullptr;
+}
@@ -0,0 +1,31 @@
+#include "enmod/SpaceTimeReservations.h"
+
+void SpaceTimeReservations::beginRound(std::size_t expected_entries) {
+    std::size_t capacity = slots.size();
+    while (capacity < 2 * expected_entries) capacity *= 2; // Keeps the load factor at or below 1/2
+    if (capacity > slots.size()) {
+        slots.assign(capacity, Slot());
+        mask = static_cast<std::uint32_t>(capacity - 1);
+        shift = 32;
+        for (std::size_t size = capacity; size > 1; size >>= 1) --shift;
+    } else {
+        for (std::uint32_t i : used) slots[i] = Slot();
+    }
+    used.clear();
+}
+
+void SpaceTimeReservations::reserve(int cell, int dt, int agent) {
+    std::uint32_t key = keyOf(cell, dt);
+    for (std::uint32_t i = home(key);; i = (i + 1) & mask) {
+        Slot& slot = slots[i];
+        if (slot.key == key) {
+            slot.agent = agent;
+            return;
+        }
+        if (slot.key == EMPTY) {
+            slot = {key, agent};
+            used.push_back(i);
+            return;
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#include "enmod/StepPolicies.h"
+#include "enmod/BIDP.h"
+#include "enmod/FIDP.h"
+#include "enmod/PolicyGenerator.h"
+#include "enmod/API.h"
+#include "enmod/Profiler.h"
+
+Direction descentDirection(const Grid& current_grid, const std::vector<std::vector<Cost>>& cost_map, const Position& current_pos) {
+    ENMOD_PROFILE_PHASE(PHASE_NEIGHBOR_SCAN);
+    static const Direction dirs[] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+    Direction best_direction = Direction::STAY;
+    Cost best_neighbor_cost = cost_map[current_pos.row][current_pos.col];
+    for (Direction dir : dirs) {
+        Position neighbor = current_grid.getNextPosition(current_pos, dir);
+        if (current_grid.isWalkable(neighbor.row, neighbor.col) && cost_map[neighbor.row][neighbor.col] < best_neighbor_cost) {
+            best_neighbor_cost = cost_map[neighbor.row][neighbor.col];
+            best_direction = dir;
+        }
+    }
+    return best_direction;
+}
+
+StepDecision descendCostMap(const Grid& current_grid, const std::vector<std::vector<Cost>>& cost_map,
+                            const Position& current_pos, const std::string& suffix) {
+    Direction dir = descentDirection(current_grid, cost_map, current_pos);
+    return {current_grid.getNextPosition(current_pos, dir), actionName(dir, suffix)};
+}
+
+StepDecision BIDPStepPolicy::decide(const Grid& current_grid, const Position& current_pos, EvacuationMode, int) {
+    BIDP step_planner(current_grid);
+    step_planner.run();
+    const auto& cost_map = step_planner.getCostMap();
+    StepDecision decision = descendCostMap(current_grid, cost_map, current_pos);
+    decision.no_path = decision.next_pos == current_pos && cost_map[current_pos.row][current_pos.col].distance == MAX_COST;
+    return decision;
+}
+
+StepDecision FIDPStepPolicy::decide(const Grid& current_grid, const Position& current_pos, EvacuationMode, int) {
+    FIDP step_planner(current_grid);
+    step_planner.run(current_pos);
+    auto path = step_planner.getEvacuationPath(current_pos);
+
+    StepDecision decision = {current_pos, actionName(Direction::STAY)};
+    if (path.size() > 1) {
+        decision.next_pos = path[1];
+        if (path[1].row < current_pos.row) decision.action = actionName(Direction::UP);
+        else if (path[1].row > current_pos.row) decision.action = actionName(Direction::DOWN);
+        else if (path[1].col < current_pos.col) decision.action = actionName(Direction::LEFT);
+        else if (path[1].col > current_pos.col) decision.action = actionName(Direction::RIGHT);
+    }
+    decision.no_path = path.empty() || (path.size() == 1 && !(path[0] == current_pos));
+    return decision;
+}
+
+StepDecision AVIStepPolicy::decide(const Grid& current_grid, const Position& current_pos, EvacuationMode, int) {
+    PolicyGenerator step_planner(current_grid);
+    step_planner.run();
+    Direction move_dir = step_planner.getPolicy().getDirection(current_pos);
+    StepDecision decision = {current_grid.getNextPosition(current_pos, move_dir), actionName(move_dir)};
+    decision.no_path = step_planner.getEvacuationCost().distance == MAX_COST;
+    return decision;
+}
+
+StepDecision FeatureQStepPolicy::decide(const Grid& current_grid, const Position& current_pos, EvacuationMode, int) {
+    FeatureGrid features(current_grid);
+    Direction move_dir = static_cast<Direction>(model.bestAction(features.features(features.cellIndex(current_pos))));
+    Position next_pos = current_grid.getNextPosition(current_pos, move_dir);
+    // A blocked move leaves the agent where it is, as the features assumed
+    if (!current_grid.isWalkable(next_pos.row, next_pos.col)) return {current_pos, actionName(Direction::STAY)};
+    return {next_pos, actionName(move_dir)};
+}
+
+StepDecision APIStepPolicy::decide(const Grid& current_grid, const Position& current_pos, EvacuationMode, int) {
+    API step_planner(current_grid);
+    step_planner.run();
+    Direction move_dir = step_planner.getPolicy().getDirection(current_pos);
+    StepDecision decision = {current_grid.getNextPosition(current_pos, move_dir), actionName(move_dir)};
+    decision.no_path = step_planner.getEvacuationCost().distance == MAX_COST;
+    return decision;
+}
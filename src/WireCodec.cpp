@@ -0,0 +1,233 @@
+#include "enmod/WireCodec.h"
+#include <cstring>
+
+namespace {
+
+constexpr std::size_t OBSERVATION_FIXED_BYTES = 48;
+constexpr std::size_t CHANGE_BYTES = 12;
+constexpr std::size_t COMMAND_FIXED_BYTES = 24;
+
+void putU32(std::uint8_t* out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+}
+
+void putU64(std::uint8_t* out, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+}
+
+std::uint32_t getU32(const std::uint8_t* in) {
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) value |= static_cast<std::uint32_t>(in[i]) << (8 * i);
+    return value;
+}
+
+std::uint64_t getU64(const std::uint8_t* in) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+    return value;
+}
+
+void putI32(std::uint8_t* out, int value) { putU32(out, static_cast<std::uint32_t>(value)); }
+int getI32(const std::uint8_t* in) { return static_cast<int>(getU32(in)); }
+
+void putHeader(std::uint8_t* out, WireFrameType type, std::size_t payload) {
+    out[0] = 'E';
+    out[1] = 'W';
+    out[2] = WireCodec::VERSION;
+    out[3] = static_cast<std::uint8_t>(type);
+    putU32(out + 4, static_cast<std::uint32_t>(payload));
+}
+
+bool putAgentId(std::uint8_t* out, const std::string& agent_id) {
+    if (agent_id.size() > WireCodec::MAX_AGENT_ID) return false;
+    std::memset(out, 0, 16);
+    std::memcpy(out, agent_id.data(), agent_id.size());
+    return true;
+}
+
+void getAgentId(const std::uint8_t* in, std::string& agent_id) {
+    agent_id.assign(reinterpret_cast<const char*>(in), strnlen(reinterpret_cast<const char*>(in), 16));
+}
+
+std::uint8_t fireSizeCode(const std::string& size) {
+    if (size == "medium") return 1;
+    if (size == "large") return 2;
+    return 0;
+}
+
+const char* fireSizeName(std::uint8_t code) {
+    if (code == 1) return "medium";
+    if (code == 2) return "large";
+    return "small";
+}
+
+std::size_t observationFixedSize(const AgentObservation& observation) {
+    return WireCodec::HEADER_BYTES + OBSERVATION_FIXED_BYTES + CHANGE_BYTES * observation.environment.changes.size();
+}
+
+// Writes everything of an observation frame up to its snapshot, which takes the snapshot_length
+// bytes after it. The agent id must already have been checked.
+void putObservation(std::uint8_t* out, const AgentObservation& observation, std::size_t snapshot_length) {
+    const EnvironmentUpdate& update = observation.environment;
+    putHeader(out, WireFrameType::OBSERVATION, observationFixedSize(observation) - WireCodec::HEADER_BYTES + snapshot_length);
+    std::uint8_t* payload = out + WireCodec::HEADER_BYTES;
+    putAgentId(payload, observation.agent_id);
+    putI32(payload + 16, observation.timestep);
+    putI32(payload + 20, observation.position.row);
+    putI32(payload + 24, observation.position.col);
+    putU64(payload + 28, update.sequence);
+    payload[36] = update.is_snapshot ? 1 : 0;
+    payload[37] = payload[38] = payload[39] = 0;
+    putU32(payload + 40, static_cast<std::uint32_t>(update.changes.size()));
+    putU32(payload + 44, static_cast<std::uint32_t>(snapshot_length));
+
+    std::uint8_t* cursor = payload + OBSERVATION_FIXED_BYTES;
+    for (const auto& change : update.changes) {
+        cursor[0] = static_cast<std::uint8_t>(change.kind);
+        cursor[1] = fireSizeCode(change.size);
+        cursor[2] = cursor[3] = 0;
+        putI32(cursor + 4, change.pos.row);
+        putI32(cursor + 8, change.pos.col);
+        cursor += CHANGE_BYTES;
+    }
+}
+
+} // namespace
+
+std::size_t WireCodec::encodeObservation(const AgentObservation& observation, std::uint8_t* out, std::size_t capacity) {
+    if (observation.agent_id.size() > MAX_AGENT_ID) return 0;
+    std::vector<std::uint8_t> snapshot;
+    if (observation.environment.is_snapshot) snapshot = json::to_cbor(*observation.environment.snapshot);
+
+    std::size_t fixed = observationFixedSize(observation);
+    if (fixed + snapshot.size() > capacity) return 0;
+    putObservation(out, observation, snapshot.size());
+    if (!snapshot.empty()) std::memcpy(out + fixed, snapshot.data(), snapshot.size());
+    return fixed + snapshot.size();
+}
+
+std::size_t WireCodec::appendObservation(const AgentObservation& observation, std::vector<std::uint8_t>& out) {
+    if (observation.agent_id.size() > MAX_AGENT_ID) return 0;
+    std::size_t start = out.size();
+    std::size_t fixed = observationFixedSize(observation);
+    out.resize(start + fixed);
+    // The snapshot is encoded straight onto the end of the frame, so it is encoded only once
+    if (observation.environment.is_snapshot) json::to_cbor(*observation.environment.snapshot, out);
+    putObservation(out.data() + start, observation, out.size() - start - fixed);
+    return out.size() - start;
+}
+
+std::size_t WireCodec::encodeCommand(const AgentCommand& command, std::uint8_t* out, std::size_t capacity) {
+    if (capacity < commandSize()) return 0;
+    std::uint8_t* payload = out + HEADER_BYTES;
+    if (!putAgentId(payload, command.agent_id)) return 0;
+    putHeader(out, WireFrameType::COMMAND, COMMAND_FIXED_BYTES);
+    putI32(payload + 16, command.timestep);
+    payload[20] = static_cast<std::uint8_t>(command.move);
+    payload[21] = command.resync ? 1 : 0;
+    payload[22] = payload[23] = 0;
+    return commandSize();
+}
+
+std::size_t WireCodec::frameLength(const std::uint8_t* data, std::size_t size) {
+    if (size < HEADER_BYTES || data[0] != 'E' || data[1] != 'W' || data[2] != VERSION) return 0;
+    return HEADER_BYTES + getU32(data + 4);
+}
+
+bool WireCodec::decodeObservation(const std::uint8_t* data, std::size_t size, AgentObservation& out) {
+    std::size_t length = frameLength(data, size);
+    if (length == 0 || length > size || frameType(data) != WireFrameType::OBSERVATION ||
+        length < HEADER_BYTES + OBSERVATION_FIXED_BYTES) {
+        return false;
+    }
+    const std::uint8_t* payload = data + HEADER_BYTES;
+    std::uint32_t change_count = getU32(payload + 40);
+    std::uint32_t snapshot_length = getU32(payload + 44);
+    if (length != HEADER_BYTES + OBSERVATION_FIXED_BYTES + CHANGE_BYTES * static_cast<std::size_t>(change_count) + snapshot_length) {
+        return false;
+    }
+
+    getAgentId(payload, out.agent_id);
+    out.timestep = getI32(payload + 16);
+    out.position = {getI32(payload + 20), getI32(payload + 24)};
+    EnvironmentUpdate& update = out.environment;
+    update.sequence = getU64(payload + 28);
+    update.is_snapshot = (payload[36] & 1) != 0;
+    update.changes.resize(change_count);
+
+    const std::uint8_t* cursor = payload + OBSERVATION_FIXED_BYTES;
+    for (auto& change : update.changes) {
+        change.kind = cursor[0] == static_cast<std::uint8_t>(EnvironmentChange::Kind::BLOCKED) ? EnvironmentChange::Kind::BLOCKED
+                                                                                              : EnvironmentChange::Kind::FIRE;
+        change.size = fireSizeName(cursor[1]); // Short literals stay in the string's inline buffer
+        change.pos = {getI32(cursor + 4), getI32(cursor + 8)};
+        cursor += CHANGE_BYTES;
+    }
+    if (update.is_snapshot) {
+        json snapshot = json::from_cbor(cursor, cursor + snapshot_length, true, false);
+        if (snapshot.is_discarded()) return false;
+        update.snapshot = std::make_shared<const json>(std::move(snapshot));
+    } else {
+        update.snapshot.reset();
+    }
+    return true;
+}
+
+bool WireCodec::decodeCommand(const std::uint8_t* data, std::size_t size, AgentCommand& out) {
+    std::size_t length = frameLength(data, size);
+    if (length != commandSize() || length > size || frameType(data) != WireFrameType::COMMAND) return false;
+    const std::uint8_t* payload = data + HEADER_BYTES;
+    getAgentId(payload, out.agent_id);
+    out.timestep = getI32(payload + 16);
+    out.move = payload[20] <= static_cast<std::uint8_t>(Direction::STAY) ? static_cast<Direction>(payload[20]) : Direction::STAY;
+    out.resync = (payload[21] & 1) != 0;
+    return true;
+}
+
+void WireTransport::ByteStream::compact() {
+    if (read_offset == bytes.size()) {
+        bytes.clear(); // Everything was read; start again at the front without giving up capacity
+        read_offset = 0;
+    }
+}
+
+std::uint8_t* WireTransport::ByteStream::reserve(std::size_t length) {
+    compact();
+    std::size_t start = bytes.size();
+    bytes.resize(start + length);
+    return bytes.data() + start;
+}
+
+const std::uint8_t* WireTransport::ByteStream::nextFrame(std::size_t& length) {
+    const std::uint8_t* data = bytes.data() + read_offset;
+    std::size_t available = bytes.size() - read_offset;
+    length = WireCodec::frameLength(data, available);
+    if (length == 0 || length > available) return nullptr;
+    read_offset += length;
+    return data;
+}
+
+bool WireTransport::sendObservation(AgentObservation observation) {
+    uplink.compact();
+    return WireCodec::appendObservation(observation, uplink.bytes) != 0;
+}
+
+bool WireTransport::receiveObservation(AgentObservation& observation) {
+    std::size_t length;
+    const std::uint8_t* frame = uplink.nextFrame(length);
+    return frame && WireCodec::decodeObservation(frame, length, observation);
+}
+
+bool WireTransport::sendCommand(AgentCommand command) {
+    std::size_t length = WireCodec::commandSize();
+    std::uint8_t* frame = downlink.reserve(length);
+    if (WireCodec::encodeCommand(command, frame, length) == length) return true;
+    downlink.bytes.resize(downlink.bytes.size() - length);
+    return false;
+}
+
+bool WireTransport::receiveCommand(AgentCommand& command) {
+    std::size_t length;
+    const std::uint8_t* frame = downlink.nextFrame(length);
+    return frame && WireCodec::decodeCommand(frame, length, command);
+}
@@ -3,28 +3,18 @@
 #include "enmod/Grid.h"
 #include "enmod/Solver.h"
 #include "enmod/HtmlReportGenerator.h"
-// Static DP Solvers
-#include "enmod/BIDP.h"
-#include "enmod/FIDP.h"
-#include "enmod/API.h"
-// Dynamic DP Solvers
-#include "enmod/DynamicBIDPSolver.h"
-#include "enmod/DynamicAPISolver.h"
-#include "enmod/DynamicFIDPSolver.h"
-#include "enmod/DynamicAVISolver.h"
-// RL Solvers (Static and Dynamic headers)
+#include "enmod/SolverFactory.h"
+#include "enmod/JobRunner.h"
+#include "enmod/RLSolver.h"
+#include "enmod/Random.h"
+#include "enmod/Benchmark.h"
+#include "enmod/Profiler.h"
+#include "enmod/ReplayLog.h"
+#include "enmod/AgentIoLog.h"
+#include "enmod/FeatureQLearningSolver.h"
 #include "enmod/QLearningSolver.h"
-#include "enmod/SARSASolver.h"
-#include "enmod/ActorCriticSolver.h"
-#include "enmod/DynamicQLearningSolver.h"
-#include "enmod/DynamicSARSASolver.h"
-#include "enmod/DynamicActorCriticSolver.h"
-// EnMod-DP Solvers
-#include "enmod/HybridDPRLSolver.h"
-#include "enmod/AdaptiveCostSolver.h"
-#include "enmod/InterlacedSolver.h"
-#include "enmod/HierarchicalSolver.h"
-#include "enmod/PolicyBlendingSolver.h"
+#include "enmod/BIDP.h"
+#include "enmod/DynamicSimulation.h"
 // Multi-Agent CPS
 #include "enmod/MultiAgentCPSController.h"
 
@@ -37,61 +27,357 @@
 #include <map>
 #include <chrono>
 #include <sstream>
+#include <cstdlib>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
 
 #ifdef _MSC_VER
 #pragma warning(disable : 4996)
 #endif
 
-void runComparisonScenario(const json& config, const std::string& report_path, std::vector<Result>& results) {
-    Grid grid(config);
-    std::cout << "\n===== Running Comparison Scenario: " << grid.getName() << " (" << grid.getRows() << "x" << grid.getCols() << ") =====\n";
-    std::string scenario_report_path = report_path + "/" + grid.getName();
-    std::filesystem::create_directory(scenario_report_path);
-    HtmlReportGenerator::generateInitialGridReport(grid, scenario_report_path);
-
-    std::vector<std::unique_ptr<Solver>> solvers;
-
-    // --- Static Planners ---
-    solvers.push_back(std::make_unique<BIDP>(grid));
-    solvers.push_back(std::make_unique<FIDP>(grid));
-    solvers.push_back(std::make_unique<API>(grid));
-    solvers.push_back(std::make_unique<QLearningSolver>(grid));
-    solvers.push_back(std::make_unique<SARSASolver>(grid));
-    solvers.push_back(std::make_unique<ActorCriticSolver>(grid));
-
-    // --- Dynamic Simulators ---
-    solvers.push_back(std::make_unique<DynamicBIDPSolver>(grid));
-    solvers.push_back(std::make_unique<DynamicFIDPSolver>(grid));
-    solvers.push_back(std::make_unique<DynamicAVISolver>(grid));
-    solvers.push_back(std::make_unique<DynamicAPISolver>(grid));
-    solvers.push_back(std::make_unique<DynamicQLearningSolver>(grid));
-    solvers.push_back(std::make_unique<DynamicSARSASolver>(grid));
-    solvers.push_back(std::make_unique<DynamicActorCriticSolver>(grid));
-
-    // --- EnMod-DP Hybrid Approaches ---
-    solvers.push_back(std::make_unique<HybridDPRLSolver>(grid));
-    solvers.push_back(std::make_unique<AdaptiveCostSolver>(grid));
-    solvers.push_back(std::make_unique<InterlacedSolver>(grid));
-    solvers.push_back(std::make_unique<HierarchicalSolver>(grid));
-    solvers.push_back(std::make_unique<PolicyBlendingSolver>(grid));
-
-
-    for (const auto& solver : solvers) {
-        std::cout << "  - Running " << solver->getName() << "... ";
-        auto start_time = std::chrono::high_resolution_clock::now();
-        solver->run();
-        auto end_time = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double, std::milli> execution_time = end_time - start_time;
-        std::cout << "Done (" << std::fixed << std::setprecision(2) << execution_time.count() << " ms).\n";
-
-        Cost final_cost = solver->getEvacuationCost();
-        double weighted_cost = (final_cost.distance == MAX_COST) ? std::numeric_limits<double>::infinity() : (final_cost.smoke * 1000) + (final_cost.time * 10) + (final_cost.distance * 1);
-        results.push_back({grid.getName(), solver->getName(), final_cost, weighted_cost, execution_time.count()});
-        HtmlReportGenerator::generateSolverReport(*solver, scenario_report_path);
+std::uint64_t resolveRunSeed() {
+    if (const char* env_seed = std::getenv("ENMOD_SEED")) {
+        return std::stoull(env_seed);
+    }
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+int resolveJobCount() {
+    if (const char* env_jobs = std::getenv("ENMOD_JOBS")) {
+        return std::stoi(env_jobs);
+    }
+    return 0; // One worker per hardware thread
+}
+
+// Runs every (scenario, solver) pair as an independent job. Each job builds its own solver and only
+// reads the scenario's Grid, so jobs share no mutable state. Results come back in scenario-major,
+// solver-registration order regardless of which job finished first.
+void runComparisonScenarios(const std::vector<json>& scenarios, const std::string& report_path, std::vector<Result>& results, int num_jobs) {
+    const auto& solver_names = SolverFactory::solverNames();
+    std::vector<std::unique_ptr<Grid>> grids;
+    std::vector<std::string> scenario_paths;
+    for (const auto& config : scenarios) {
+        grids.push_back(std::make_unique<Grid>(config));
+        const Grid& grid = *grids.back();
+        std::cout << "\n===== Queued Comparison Scenario: " << grid.getName() << " (" << grid.getRows() << "x" << grid.getCols() << ") =====\n";
+        scenario_paths.push_back(report_path + "/" + grid.getName());
+        std::filesystem::create_directory(scenario_paths.back());
+        HtmlReportGenerator::generateInitialGridReport(grid, scenario_paths.back());
+    }
+
+    std::vector<Result> slots(grids.size() * solver_names.size());
+    std::vector<std::function<void()>> jobs;
+    std::mutex console_mutex;
+    for (std::size_t s = 0; s < grids.size(); ++s) {
+        for (std::size_t k = 0; k < solver_names.size(); ++k) {
+            jobs.push_back([&, s, k]() {
+                const Grid& grid = *grids[s];
+                Profiler::take(); // Drop whatever the previous job on this worker left behind
+                auto solver = SolverFactory::create(solver_names[k], grid);
+                HardwareCounters hardware;
+                auto start_time = std::chrono::steady_clock::now();
+                solver->run();
+                auto end_time = std::chrono::steady_clock::now();
+                std::chrono::duration<double, std::milli> execution_time = end_time - start_time;
+                hardware.stop(Profiler::current());
+
+                Cost final_cost = solver->getEvacuationCost();
+                Result& slot = slots[s * solver_names.size() + k];
+                slot = {grid.getName(), solver->getName(), final_cost, weightedCost(final_cost), execution_time.count(), {}};
+                {
+                    ENMOD_PROFILE_PHASE(PHASE_REPORT);
+                    HtmlReportGenerator::generateSolverReport(*solver, scenario_paths[s]);
+                    solver->writeReplay(scenario_paths[s] + "/" + solver->getName() + ".replay", RLSolver::run_seed);
+                }
+                slot.profile = Profiler::take();
+
+                std::lock_guard<std::mutex> lock(console_mutex);
+                std::cout << "  - [" << grid.getName() << "] " << solver->getName() << " done ("
+                          << std::fixed << std::setprecision(2) << execution_time.count() << " ms).\n";
+            });
+        }
+    }
+
+    JobRunner runner(num_jobs);
+    std::cout << "\nRunning " << jobs.size() << " solver jobs on " << std::min<std::size_t>(runner.getNumWorkers(), jobs.size()) << " worker threads.\n";
+    auto start_time = std::chrono::steady_clock::now();
+    runner.run(jobs);
+    std::chrono::duration<double> wall_time = std::chrono::steady_clock::now() - start_time;
+    std::cout << "All solver jobs finished in " << std::fixed << std::setprecision(2) << wall_time.count() << " s.\n";
+    Logger::log(LogLevel::INFO, "Ran " + std::to_string(jobs.size()) + " solver jobs on " + std::to_string(runner.getNumWorkers()) +
+                " workers in " + std::to_string(wall_time.count()) + " s.");
+
+    results.insert(results.end(), slots.begin(), slots.end());
+}
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+// --benchmark [--sizes 5,10,...] [--solvers BIDP,...] [--reps N] [--warmup N] [--budget-ms X] [--trace-decay LAMBDA] [--batch-lanes N] [--train-workers N] [--out PREFIX]
+int runBenchmark(const std::vector<std::string>& args, const std::string& default_prefix) {
+    BenchmarkOptions options;
+    options.seed = RLSolver::run_seed;
+    std::string prefix = default_prefix;
+    for (std::size_t i = 0; i + 1 < args.size(); ++i) {
+        const std::string& flag = args[i];
+        const std::string& value = args[i + 1];
+        if (flag == "--sizes") {
+            options.grid_sizes.clear();
+            for (const auto& size : splitList(value)) options.grid_sizes.push_back(std::stoi(size));
+        } else if (flag == "--solvers") {
+            options.solvers = splitList(value);
+        } else if (flag == "--reps") {
+            options.repetitions = std::max(1, std::stoi(value));
+        } else if (flag == "--warmup") {
+            options.warmup = std::max(0, std::stoi(value));
+        } else if (flag == "--budget-ms") {
+            options.time_budget_ms = std::stod(value);
+        } else if (flag == "--trace-decay") {
+            options.trace_decay = std::min(1.0, std::max(0.0, std::stod(value)));
+        } else if (flag == "--batch-lanes") {
+            options.batch_lanes = std::max(0, std::stoi(value));
+        } else if (flag == "--train-workers") {
+            options.train_workers = std::max(1, std::stoi(value));
+        } else if (flag == "--out") {
+            prefix = value;
+        } else {
+            continue;
+        }
+        ++i;
+    }
+
+    BenchmarkRunner runner(options);
+    auto records = runner.run();
+    BenchmarkRunner::writeCsv(records, prefix + ".csv");
+    BenchmarkRunner::writeJson(records, options, prefix + ".json");
+    std::cout << "\nBenchmark complete. Results written to " << prefix << ".csv and " << prefix << ".json\n";
+    Logger::log(LogLevel::INFO, "Benchmark results written to " + prefix + ".csv/.json");
+    return 0;
+}
+
+// --agent-benchmark [--agents 10,100,...] [--size N] [--steps N] [--out PREFIX]; ENMOD_JOBS sets the planning threads
+int runAgentBenchmark(const std::vector<std::string>& args, const std::string& default_prefix) {
+    AgentScalingOptions options;
+    options.seed = RLSolver::run_seed;
+    options.workers = resolveJobCount();
+    std::string prefix = default_prefix;
+    for (std::size_t i = 0; i + 1 < args.size(); ++i) {
+        const std::string& flag = args[i];
+        const std::string& value = args[i + 1];
+        if (flag == "--agents") {
+            options.agent_counts.clear();
+            for (const auto& count : splitList(value)) options.agent_counts.push_back(std::stoi(count));
+        } else if (flag == "--size") {
+            options.grid_size = std::stoi(value);
+        } else if (flag == "--steps") {
+            options.timesteps = std::max(1, std::stoi(value));
+        } else if (flag == "--out") {
+            prefix = value;
+        } else {
+            continue;
+        }
+        ++i;
+    }
+
+    AgentScalingBenchmark benchmark(options);
+    auto records = benchmark.run(prefix);
+    AgentScalingBenchmark::writeCsv(records, prefix + ".csv");
+    std::cout << "\nAgent scaling benchmark complete. Results written to " << prefix << ".csv\n";
+    Logger::log(LogLevel::INFO, "Agent scaling results written to " + prefix + ".csv");
+    return 0;
+}
+
+// --replay FILE [--at T]: prints every agent's state at timestep T (default the last) of a recorded
+// run and renders it to FILE_tT.html, without running any planner
+int runReplay(const std::vector<std::string>& args) {
+    std::string path;
+    int timestep = -1;
+    for (std::size_t i = 0; i + 1 < args.size(); ++i) {
+        if (args[i] == "--replay") path = args[++i];
+        else if (args[i] == "--at") timestep = std::stoi(args[++i]);
+    }
+    if (path.empty()) throw std::invalid_argument("--replay needs a replay file");
+
+    ReplayReader reader(path);
+    if (timestep < 0) timestep = reader.getNumSteps() - 1;
+    ReplayState state = reader.stateAt(timestep);
+    std::cout << path << ": " << reader.getNumAgents() << " agents, " << reader.getNumSteps() << " timesteps, seed " << reader.getSeed()
+              << ", grid hash " << std::hex << reader.getGridHash() << std::dec << "\n";
+    std::cout << "Timestep " << timestep << " on " << state.grid.getName() << ":\n";
+    const char* mode_names[] = {"NORMAL", "ALERT", "PANIC"};
+    for (std::size_t i = 0; i < state.positions.size(); ++i) {
+        const Position& pos = state.positions[i];
+        std::cout << "  agent_" << i << " at (" << pos.row << ", " << pos.col << ") ";
+        if (state.grid.isExit(pos.row, pos.col)) std::cout << "out\n";
+        else std::cout << mode_names[static_cast<int>(state.modes[i])] << " " << actionName(state.moves[i]) << "\n";
+    }
+
+    std::string html = path + "_t" + std::to_string(timestep) + ".html";
+    MultiAgentReportGenerator report(html);
+    report.add_timestep(timestep, state.grid, state.positions);
+    report.finalize_report();
+    std::cout << "Rendered to " << html << "\n";
+    return 0;
+}
+
+// --io-log DIR --agent N [--at T]: prints what agent N (an index, or a full agent id) reported and
+// was told at timestep T (default every logged one), from the agent I/O log a multi-agent run with
+// ENMOD_AGENT_TRANSPORT=file wrote to DIR
+int runIoLog(const std::vector<std::string>& args) {
+    std::string directory, agent_id;
+    int timestep = -1;
+    for (std::size_t i = 0; i + 1 < args.size(); ++i) {
+        if (args[i] == "--io-log") directory = args[++i];
+        else if (args[i] == "--agent") agent_id = args[++i];
+        else if (args[i] == "--at") timestep = std::stoi(args[++i]);
+    }
+    if (directory.empty() || agent_id.empty()) throw std::invalid_argument("--io-log needs a log directory and --agent");
+    if (agent_id.find_first_not_of("0123456789") == std::string::npos) agent_id = "agent_" + agent_id;
+
+    AgentIoLogReader reader(directory);
+    std::vector<int> timesteps = timestep >= 0 ? std::vector<int>{timestep} : reader.getTimesteps(agent_id);
+    std::cout << directory << ": " << reader.getNumMessages() << " messages; " << agent_id << " at "
+              << timesteps.size() << " timesteps\n";
+    AgentObservation observation;
+    AgentCommand command;
+    for (int t : timesteps) {
+        std::cout << "  t" << t << ": ";
+        if (reader.readObservation(agent_id, t, observation)) {
+            const EnvironmentUpdate& update = observation.environment;
+            std::cout << "at (" << observation.position.row << ", " << observation.position.col << "), update #" << update.sequence
+                      << (update.is_snapshot ? " snapshot" : "") << " with " << update.changes.size() << " changes";
+        } else {
+            std::cout << "no observation";
+        }
+        if (reader.readCommand(agent_id, t, command)) {
+            std::cout << " -> " << actionName(command.move) << (command.resync ? " (resync)" : "") << "\n";
+        } else {
+            std::cout << " -> no command\n";
+        }
     }
+    return 0;
 }
 
-int main() {
+// --feature-transfer [--sizes 10,20,...] [--grids N]: fits FeatureQLearning on one 15x15 layout and
+// runs its weights, untouched, on N other layouts of each size (default 20), all from the run seed.
+// Reports how often they reach an exit and their cost next to BIDP's; exits with 1 if they miss an
+// exit BIDP reaches.
+int runFeatureTransfer(const std::vector<std::string>& args) {
+    std::vector<int> sizes = {10, 20, 40};
+    int num_grids = 20;
+    for (std::size_t i = 0; i + 1 < args.size(); ++i) {
+        if (args[i] == "--sizes") {
+            sizes.clear();
+            for (const auto& size : splitList(args[++i])) sizes.push_back(std::stoi(size));
+        } else if (args[i] == "--grids") {
+            num_grids = std::max(1, std::stoi(args[++i]));
+        }
+    }
+
+    Grid training_grid(ScenarioGenerator::generate(15, "transfer_training",
+                                                   static_cast<std::uint32_t>(deriveSeed(RLSolver::run_seed, "transfer_training"))));
+    FeatureQLearningSolver trainer(training_grid);
+    trainer.run();
+    std::cout << "Fitted on " << training_grid.getName() << "; weights";
+    for (int f = 0; f < NUM_FEATURES; ++f) std::cout << " " << trainer.getModel().getWeights()[f];
+    std::cout << "\n";
+
+    int missed = 0;
+    for (int size : sizes) {
+        int solvable = 0, reached = 0;
+        double cost_ratio = 0.0;
+        for (int g = 0; g < num_grids; ++g) {
+            std::string name = std::to_string(size) + "x" + std::to_string(size) + "_" + std::to_string(g);
+            Grid grid(ScenarioGenerator::generate(size, name, static_cast<std::uint32_t>(deriveSeed(RLSolver::run_seed, "transfer" + name))));
+            BIDP reference(grid);
+            reference.run();
+            if (reference.getEvacuationCost().distance == MAX_COST) continue;
+            ++solvable;
+
+            FeatureQLearningSolver solver(grid);
+            solver.setModel(trainer.getModel());
+            solver.run();
+            Cost cost = solver.getEvacuationCost();
+            if (cost.distance == MAX_COST) {
+                Logger::log(LogLevel::WARN, "Transferred feature model reaches no exit on " + name);
+                continue;
+            }
+            ++reached;
+            cost_ratio += weightedCost(cost) / std::max(1.0, weightedCost(reference.getEvacuationCost()));
+        }
+        missed += solvable - reached;
+        std::cout << "  " << size << "x" << size << ": " << reached << "/" << solvable << " solvable layouts reach an exit";
+        if (reached > 0) std::cout << ", mean cost " << std::fixed << std::setprecision(2) << cost_ratio / reached << "x BIDP" << std::defaultfloat;
+        std::cout << "\n";
+    }
+    return missed > 0 ? 1 : 0;
+}
+
+// --parallel-training [--size N] [--workers N] [--episodes N]: trains Q-learning for a fixed budget on
+// one layout from the run seed, on one thread and on N workers (default 4), and reports episodes/sec
+// for both. Trains the N-worker run twice more from the same seed; exits with 1 if the two merged
+// tables are not identical.
+int runParallelTraining(const std::vector<std::string>& args) {
+    int size = 40;
+    int workers = 4;
+    int episodes = 5000;
+    for (std::size_t i = 0; i + 1 < args.size(); ++i) {
+        if (args[i] == "--size") size = std::max(2, std::stoi(args[++i]));
+        else if (args[i] == "--workers") workers = std::max(1, std::stoi(args[++i]));
+        else if (args[i] == "--episodes") episodes = std::max(1, std::stoi(args[++i]));
+    }
+
+    Grid grid(ScenarioGenerator::generate(size, "parallel_training",
+                                          static_cast<std::uint32_t>(deriveSeed(RLSolver::run_seed, "parallel_training"))));
+    TrainingOptions options;
+    options.max_episodes = episodes;
+    options.check_interval = 0; // Fixed budget, so both runs do the same amount of work
+    auto train = [&](int num_workers) {
+        auto solver = std::make_unique<QLearningSolver>(grid);
+        solver->setTrainingWorkers(num_workers);
+        auto start_time = std::chrono::steady_clock::now();
+        solver->runTraining(options);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+        std::cout << "  " << num_workers << " worker(s): " << static_cast<long long>(episodes / std::max(elapsed.count(), 1e-9))
+                  << " episodes/sec\n";
+        return solver;
+    };
+
+    std::cout << "Training Q-learning for " << episodes << " episodes on " << grid.getName() << " (" << size << "x" << size << ")\n";
+    train(1);
+    auto first = train(workers);
+    auto second = train(workers);
+
+    const ValueTable& a = first->getValueTable();
+    const ValueTable& b = second->getValueTable();
+    int differing = 0;
+    for (int cell = 0; cell < a.numCells(); ++cell) {
+        bool same = a.isVisited(cell) == b.isVisited(cell);
+        for (int action = 0; action < NUM_ACTIONS && same; ++action) same = a.values(cell)[action] == b.values(cell)[action];
+        if (!same) ++differing;
+    }
+    if (differing > 0) {
+        std::cout << "Merged tables differ in " << differing << " of " << a.numCells() << " cells for the same seed\n";
+        Logger::log(LogLevel::ERROR, "ParallelTrainer is not deterministic: " + std::to_string(differing) + " cells differ");
+        return 1;
+    }
+    std::cout << "Merged tables are identical for the same seed and worker count\n";
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
     try {
         std::filesystem::create_directory("logs");
         std::filesystem::create_directory("reports");
@@ -105,16 +391,52 @@ int main() {
         std::cout << "Log file created at: logs/enmod_simulation.log\n";
         std::cout << "Reports will be generated in: " << report_root_path << "\n";
 
+        RLSolver::run_seed = resolveRunSeed();
+        std::cout << "Run seed: " << RLSolver::run_seed << " (set ENMOD_SEED to reproduce)\n";
+        Logger::log(LogLevel::INFO, "Run seed: " + std::to_string(RLSolver::run_seed));
+
+        if (std::find(args.begin(), args.end(), "--benchmark") != args.end()) {
+            int status = runBenchmark(args, "reports/benchmark_" + ss.str());
+            Logger::close();
+            return status;
+        }
+        if (std::find(args.begin(), args.end(), "--feature-transfer") != args.end()) {
+            int status = runFeatureTransfer(args);
+            Logger::close();
+            return status;
+        }
+        if (std::find(args.begin(), args.end(), "--parallel-training") != args.end()) {
+            int status = runParallelTraining(args);
+            Logger::close();
+            return status;
+        }
+        if (std::find(args.begin(), args.end(), "--replay") != args.end()) {
+            int status = runReplay(args);
+            Logger::close();
+            return status;
+        }
+        if (std::find(args.begin(), args.end(), "--io-log") != args.end()) {
+            int status = runIoLog(args);
+            Logger::close();
+            return status;
+        }
+        if (std::find(args.begin(), args.end(), "--agent-benchmark") != args.end()) {
+            int status = runAgentBenchmark(args, "reports/agent_benchmark_" + ss.str());
+            Logger::close();
+            return status;
+        }
+
         // --- PHASE 1: Run the comprehensive comparison of all solvers ---
         std::vector<json> scenarios;
-        scenarios.push_back(ScenarioGenerator::generate(5, "5x5"));
-        scenarios.push_back(ScenarioGenerator::generate(10, "10x10"));
-        scenarios.push_back(ScenarioGenerator::generate(15, "15x15"));
+        // Layouts follow the run seed too, so ENMOD_SEED (and a replay's recorded seed) reproduces the whole run
+        for (int size : {5, 10, 15}) {
+            std::string name = std::to_string(size) + "x" + std::to_string(size);
+            scenarios.push_back(ScenarioGenerator::generate(size, name, static_cast<std::uint32_t>(deriveSeed(RLSolver::run_seed, "scenario" + name))));
+        }
 
+        // Solvers run concurrently; set ENMOD_JOBS=1 for timings free of contention between jobs
         std::vector<Result> all_results;
-        for (const auto& config : scenarios) {
-            runComparisonScenario(config, report_root_path, all_results);
-        }
+        runComparisonScenarios(scenarios, report_root_path, all_results, resolveJobCount());
 
         HtmlReportGenerator::generateSummaryReport(all_results, report_root_path);
         std::cout << "\nComparison simulation complete. Summary written to " << report_root_path << "/_Summary_Report.html\n";
@@ -122,7 +444,7 @@ int main() {
         // --- PHASE 2: Run the multi-agent simulation with the best hybrid solver ---
         std::cout << "\n--- Starting Multi-Agent Simulation with HybridDPRLSolver ---\n";
         for(const auto& config : scenarios) {
-            MultiAgentCPSController cps_controller(config, report_root_path + "/" + config["name"].get<std::string>(), 5);
+            MultiAgentCPSController cps_controller(config, report_root_path + "/" + config["name"].get<std::string>(), 5, resolveJobCount());
             cps_controller.run_simulation();
         }
 